@@ -0,0 +1,556 @@
+#include "../src/Core/Cipher/Alphabets.hpp"
+#include "../src/Core/Cipher/Cipher.hpp"
+#include "../src/Utils/CountingResource.hpp"
+#include "../src/Utils/StringUtils.hpp"
+
+#include <utfcpp/utf8.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Every global allocation of the process is counted
+static std::atomic<size_t> globalAllocations{ 0 };
+
+// The replacements stay out of line: GCC otherwise inlines a delete into its caller, sees free()
+// on memory from operator new and warns with -Wmismatched-new-delete
+#if defined(_MSC_VER) && !defined(__clang__)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+#ifdef _MSC_VER
+static void* AlignedAlloc(size_t alignment, size_t size) { return _aligned_malloc(size, alignment); }
+static void AlignedFree(void* p) { _aligned_free(p); }
+#else
+static void* AlignedAlloc(size_t alignment, size_t size) { return std::aligned_alloc(alignment, size); }
+static void AlignedFree(void* p) { std::free(p); }
+#endif
+
+BENCH_NOINLINE void* operator new(size_t size)
+{
+	globalAllocations++;
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+BENCH_NOINLINE void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+BENCH_NOINLINE void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+// std::pmr::new_delete_resource allocates through the aligned forms
+BENCH_NOINLINE void* operator new(size_t size, std::align_val_t alignment)
+{
+	globalAllocations++;
+	size_t align = static_cast<size_t>(alignment);
+	if (void* p = AlignedAlloc(align, (size + align - 1) / align * align))
+		return p;
+	throw std::bad_alloc();
+}
+
+BENCH_NOINLINE void operator delete(void* p, std::align_val_t) noexcept
+{
+	AlignedFree(p);
+}
+
+BENCH_NOINLINE void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+	AlignedFree(p);
+}
+
+static const std::string alphabet = "АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+static const std::string keyword = "КЛЮЧ";
+
+static std::string GenerateText(size_t bytes)
+{
+	static const char* symbols[] = {
+		"А", "Б", "В", "Г", "Д", "Е", "Ё", "Ж", "З", "И", "Й", "К", "Л", "М", "Н", "О", "П",
+		"Р", "С", "Т", "У", "Ф", "Х", "Ц", "Ч", "Ш", "Щ", "Ъ", "Ы", "Ь", "Э", "Ю", "Я", " ", ","
+	};
+
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<size_t> pick(0, std::size(symbols) - 1);
+
+	std::string text;
+	text.reserve(bytes + 2);
+	while (text.size() < bytes)
+		text += symbols[pick(rng)];
+	return text;
+}
+
+template <class F>
+static double Measure(F&& f, int runs = 1)
+{
+	double best = 0;
+	for (int i = 0; i < runs; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto stop = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(stop - start).count();
+		if (i == 0 || seconds < best) best = seconds;
+	}
+	return best;
+}
+
+// Peak resident set size of the process so far, in bytes
+static size_t PeakRss()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return static_cast<size_t>(usage.ru_maxrss);
+#else
+	return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// Text over alphabet with about one code point in ten from outside it
+static std::string GenerateText(std::u32string const& alphabet, size_t bytes, uint32_t seed)
+{
+	static const char32_t outside[] = { U'\n', U'—', U'«', U'»', U'№', U'\t' };
+
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+	std::uniform_int_distribution<size_t> pickOutside(0, std::size(outside) - 1);
+
+	std::string text;
+	text.reserve(bytes + 4);
+	while (text.size() < bytes)
+		string_utils::append_utf8(text, rng() % 10 == 0 ? outside[pickOutside(rng)] : alphabet[pick(rng)]);
+	return text;
+}
+
+static std::string GenerateKey(std::u32string const& alphabet, size_t length)
+{
+	std::mt19937 rng(static_cast<uint32_t>(length));
+	std::uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+
+	std::string key;
+	for (size_t i = 0; i < length; ++i)
+		string_utils::append_utf8(key, alphabet[pick(rng)]);
+	return key;
+}
+
+static size_t CodePoints(std::string_view text)
+{
+	size_t count = 0;
+	for (unsigned char c : text)
+		count += (c & 0xC0) != 0x80;
+	return count;
+}
+
+struct SuiteOptions {
+	size_t minBytes = 1 << 10;
+	size_t maxBytes = 64u << 20;
+	double minSeconds = 0.2;
+	const char* json = nullptr;
+};
+
+struct SuiteResult {
+	std::string name;
+	std::string alphabet;
+	size_t bytes = 0;			// input size of one call
+	size_t chars = 0;			// code points of that input
+	size_t keyLength = 0;
+	std::string separator;
+	size_t iterations = 0;
+	double nsPerChar = 0;
+	double mbPerSecond = 0;
+	double allocationsPerCall = 0;
+	size_t peakRss = 0;			// process peak after the case
+};
+
+class Suite
+{
+	SuiteOptions m_options;
+	std::vector<SuiteResult> m_results;
+
+	static void JsonString(std::FILE* out, std::string_view text) {
+		std::fputc('"', out);
+		for (unsigned char c : text) {
+			if (c == '"' || c == '\\')
+				std::fprintf(out, "\\%c", c);
+			else if (c < 0x20)
+				std::fprintf(out, "\\u%04x", c);
+			else
+				std::fputc(c, out);
+		}
+		std::fputc('"', out);
+	}
+public:
+	explicit Suite(SuiteOptions options) : m_options(options) {}
+
+	SuiteOptions const& Options() const { return m_options; }
+
+	// Runs f often enough to fill minSeconds and records the mean time of one call
+	template <class F>
+	void Run(SuiteResult result, F&& f) {
+		f();
+		size_t before = globalAllocations;
+		auto start = std::chrono::steady_clock::now();
+		f();
+		double first = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.allocationsPerCall = static_cast<double>(globalAllocations - before);
+
+		size_t iterations = 1;
+		double seconds = first;
+		if (first < m_options.minSeconds) {
+			iterations = static_cast<size_t>(m_options.minSeconds / std::max(first, 1e-9)) + 1;
+			start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < iterations; ++i)
+				f();
+			seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / iterations;
+		}
+
+		result.iterations = iterations;
+		result.nsPerChar = seconds * 1e9 / std::max<size_t>(result.chars, 1);
+		result.mbPerSecond = result.bytes / seconds / (1 << 20);
+		result.peakRss = PeakRss();
+
+		std::string separator = result.separator.empty() ? "-" : "\"" + result.separator + "\"";
+		std::printf("%-14s %-6s %-11zu %-4zu %-6s %-10.2f %-10.1f %-10.1f %-8zu\n",
+			result.name.c_str(), result.alphabet.c_str(), result.bytes, result.keyLength,
+			separator.c_str(), result.nsPerChar,
+			result.mbPerSecond, result.allocationsPerCall, result.peakRss >> 20);
+		std::fflush(stdout);
+		m_results.push_back(std::move(result));
+	}
+
+	void WriteJson(const char* path) const {
+		std::FILE* out = std::fopen(path, "wb");
+		if (!out) {
+			std::fprintf(stderr, "cannot write %s\n", path);
+			return;
+		}
+
+		const char* levels[] = { "scalar", "sse4.1", "avx2" };
+		std::fprintf(out, "{\n  \"schema\": 1,\n  \"simd\": \"%s\",\n  \"results\": [\n",
+			levels[static_cast<int>(string_utils::get_simd_level())]);
+		for (size_t i = 0; i < m_results.size(); ++i) {
+			auto const& r = m_results[i];
+			std::fprintf(out, "    { \"name\": ");
+			JsonString(out, r.name);
+			std::fprintf(out, ", \"alphabet\": ");
+			JsonString(out, r.alphabet);
+			std::fprintf(out, ", \"bytes\": %zu, \"chars\": %zu, \"key_length\": %zu, \"separator\": ",
+				r.bytes, r.chars, r.keyLength);
+			JsonString(out, r.separator);
+			std::fprintf(out, ", \"iterations\": %zu, \"ns_per_char\": %.4f, \"mb_per_s\": %.3f, "
+				"\"allocations_per_call\": %.2f, \"peak_rss_bytes\": %zu }%s\n",
+				r.iterations, r.nsPerChar, r.mbPerSecond, r.allocationsPerCall, r.peakRss,
+				i + 1 < m_results.size() ? "," : "");
+		}
+		std::fprintf(out, "  ]\n}\n");
+		std::fclose(out);
+	}
+};
+
+// Runs the steps of key preparation one at a time on an already prepared key
+class PreparedKeyBench
+{
+public:
+	static std::u32string GetUniqueKey(PreparedKey& key, std::u32string const& keyword) {
+		return key.GetUniqueKey(keyword);
+	}
+	static size_t BuildTable(PreparedKey& key, std::u32string const& uniqueKey) {
+		return key.BuildTable(uniqueKey).tokens.size();
+	}
+};
+
+static void BenchSuite(SuiteOptions const& options)
+{
+	struct NamedAlphabet {
+		const char* name;
+		const char* symbols;
+	};
+
+	const NamedAlphabet alphabetList[] = {
+		{ "rus", alphabets::Russian },
+		{ "mixed", alphabets::Mixed },
+	};
+	const size_t keyLengths[] = { 4, 32, 256 };
+	const char* separators[] = { " ", " | ", "" };
+
+	Suite suite(options);
+	std::printf("%-14s %-6s %-11s %-4s %-6s %-10s %-10s %-10s %-8s\n",
+		"case", "abc", "bytes", "key", "sep", "ns/char", "MB/s", "allocs", "rss, MB");
+
+	for (auto const& alphabet : alphabetList) {
+		std::u32string symbols = string_utils::utf8_to_u32(std::string(alphabet.symbols));
+		AlphabetIndex index(symbols);
+
+		// Key preparation: GetUniqueKey, BuildTable and the encode schedule of one PreparedKey,
+		// under the legacy and the portable key schedule, then the first two on their own
+		for (size_t keyLength : keyLengths) {
+			std::string keyword = GenerateKey(symbols, keyLength);
+			std::u32string key = string_utils::utf8_to_u32(keyword);
+			SuiteResult result{ "Prepare", alphabet.name, keyword.size(), keyLength, keyLength, " " };
+			suite.Run(result, [&] { PreparedKey prepared(index, U" ", key); });
+			result.name = "Prepare v1";
+			suite.Run(result, [&] { PreparedKey prepared(index, U" ", key, KeySchedule::V1); });
+
+			PreparedKey prepared(index, U" ", key);
+			std::u32string uniqueKey = PreparedKeyBench::GetUniqueKey(prepared, key);
+			volatile size_t sink = 0;
+			result.name = "GetUniqueKey";
+			suite.Run(result, [&] { sink = PreparedKeyBench::GetUniqueKey(prepared, key).size(); });
+			result.name = "BuildTable";
+			suite.Run(result, [&] { sink = PreparedKeyBench::BuildTable(prepared, uniqueKey); });
+		}
+
+		for (size_t bytes = options.minBytes; bytes <= options.maxBytes; bytes *= 4) {
+			std::string text = GenerateText(symbols, bytes, 42);
+			size_t chars = CodePoints(text);
+
+			for (const char* separator : separators) {
+				Cipher cipher(alphabet.symbols, separator);
+				std::string key = GenerateKey(symbols, keyLengths[0]);
+				auto prepared = cipher.Prepare(key);
+
+				std::string encoded, decoded;
+				suite.Run({ "Encode", alphabet.name, text.size(), chars, keyLengths[0], separator },
+					[&] { prepared->Encode(text, encoded); });
+				suite.Run({ "Decode", alphabet.name, encoded.size(), CodePoints(encoded), keyLengths[0], separator },
+					[&] { prepared->Decode(encoded, decoded); });
+			}
+
+			std::u32string wide;
+			std::string narrow;
+			suite.Run({ "utf8_to_u32", alphabet.name, text.size(), chars, 0, "" },
+				[&] { wide = string_utils::utf8_to_u32(text); });
+			suite.Run({ "u32_to_utf8", alphabet.name, text.size(), chars, 0, "" },
+				[&] { narrow = string_utils::u32_to_utf8(wide); });
+			suite.Run({ "to_upper", alphabet.name, text.size(), chars, 0, "" },
+				[&] { narrow = string_utils::to_upper(text); });
+		}
+
+		// Key length only matters through the table, checked on one mid-sized input
+		std::string text = GenerateText(symbols, std::min<size_t>(options.maxBytes, 1 << 20), 42);
+		for (size_t keyLength : keyLengths) {
+			if (keyLength == keyLengths[0])
+				continue;
+			Cipher cipher(alphabet.symbols);
+			auto prepared = cipher.Prepare(GenerateKey(symbols, keyLength));
+			std::string encoded, decoded;
+			suite.Run({ "Encode", alphabet.name, text.size(), CodePoints(text), keyLength, " " },
+				[&] { prepared->Encode(text, encoded); });
+			suite.Run({ "Decode", alphabet.name, encoded.size(), CodePoints(encoded), keyLength, " " },
+				[&] { prepared->Decode(encoded, decoded); });
+		}
+	}
+
+	if (options.json)
+		suite.WriteJson(options.json);
+}
+
+static void BenchDecodeScaling()
+{
+	Cipher cipher(alphabet);
+
+	std::printf("%-12s %-12s %-12s %-10s\n", "input", "decode, s", "ns/byte", "MB/s");
+	for (size_t bytes = 1 << 20; bytes <= (16u << 20); bytes <<= 1) {
+		std::string encoded = cipher.Encode(GenerateText(bytes), keyword);
+
+		std::string decoded;
+		double seconds = Measure([&] { decoded = cipher.Decode(encoded, keyword); });
+
+		std::printf("%-12zu %-12.3f %-12.2f %-10.1f\n", encoded.size(), seconds,
+			seconds * 1e9 / encoded.size(), encoded.size() / seconds / (1 << 20));
+	}
+}
+
+static void BenchParallel(KeySchedule schedule, char const* name)
+{
+	Cipher cipher(alphabet, " ", schedule);
+	std::string text = GenerateText(64u << 20);
+	std::string expectedEncoded = cipher.Encode(text, keyword);
+	std::string expectedDecoded = cipher.Decode(expectedEncoded, keyword);
+
+	unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+	std::printf("\nkey schedule %s\n", name);
+	std::printf("%-10s %-12s %-10s %-12s %-10s\n", "threads", "encode MB/s", "speedup", "decode MB/s", "speedup");
+	double singleEncode = 0, singleDecode = 0;
+	for (unsigned threads = 1; threads <= cores; threads *= 2) {
+		std::string encoded, decoded;
+		double encode = Measure([&] { encoded = cipher.EncodeParallel(text, keyword, threads); }, 3);
+		double decode = Measure([&] { decoded = cipher.DecodeParallel(expectedEncoded, keyword, threads); }, 3);
+		if (threads == 1) {
+			singleEncode = encode;
+			singleDecode = decode;
+		}
+
+		bool match = encoded == expectedEncoded && decoded == expectedDecoded;
+		std::printf("%-10u %-12.1f %-10.2f %-12.1f %-10.2f%s\n", threads,
+			text.size() / encode / (1 << 20), singleEncode / encode,
+			expectedEncoded.size() / decode / (1 << 20), singleDecode / decode, match ? "" : "  MISMATCH");
+	}
+}
+
+static void BenchAllocations()
+{
+	constexpr int calls = 100;
+
+	Cipher cipher(alphabet);
+	std::string text = GenerateText(64 << 10);
+	std::string encoded = cipher.Encode(text, keyword);
+
+	// One arena per request: the buffer is allocated once, release() rewinds it between calls
+	CountingResource upstream;
+	std::vector<char> buffer(4 << 20);
+	std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), &upstream);
+
+	auto perCall = [&](auto&& call) {
+		call();
+		upstream.Reset();
+		size_t before = globalAllocations;
+		for (int i = 0; i < calls; ++i)
+			call();
+		return std::pair{ static_cast<double>(globalAllocations - before) / calls,
+			static_cast<double>(upstream.GetAllocations()) / calls };
+	};
+
+	struct Row {
+		const char* name;
+		std::pair<double, double> allocations;
+	};
+
+	Row rows[] = {
+		{ "Encode", perCall([&] { auto r = cipher.Encode(text, keyword); }) },
+		{ "Decode", perCall([&] { auto r = cipher.Decode(encoded, keyword); }) },
+		{ "Encode, arena", perCall([&] { { auto r = cipher.Encode(text, keyword, &arena); } arena.release(); }) },
+		{ "Decode, arena", perCall([&] { { auto r = cipher.Decode(encoded, keyword, &arena); } arena.release(); }) },
+	};
+
+	std::printf("\n%-16s %-20s %-20s\n", "call", "heap allocs/call", "arena upstream/call");
+	for (auto const& row : rows)
+		std::printf("%-16s %-20.2f %-20.2f\n", row.name, row.allocations.first, row.allocations.second);
+}
+
+static void BenchTranscoding()
+{
+	struct Sample {
+		const char* name;
+		std::string text;
+	};
+
+	std::string ascii;
+	for (size_t i = 0; ascii.size() < (16u << 20); ++i)
+		ascii += "The quick brown fox jumps over the lazy dog. ";
+
+	Sample samples[] = {
+		{ "ascii", ascii },
+		{ "cyrillic", GenerateText(16u << 20) },
+	};
+
+	const char* levels[] = { "scalar", "sse4.1", "avx2" };
+
+	std::printf("\n%-10s %-10s %-14s %-14s\n", "text", "impl", "utf8->u32 MB/s", "u32->utf8 MB/s");
+	for (auto const& sample : samples) {
+		std::u32string wide;
+		double decode = Measure([&] {
+			wide.clear();
+			utf8::utf8to32(sample.text.begin(), sample.text.end(), std::back_inserter(wide));
+		}, 5);
+		std::string narrow;
+		double encode = Measure([&] {
+			narrow.clear();
+			utf8::utf32to8(wide.begin(), wide.end(), std::back_inserter(narrow));
+		}, 5);
+		std::printf("%-10s %-10s %-14.1f %-14.1f\n", sample.name, "utfcpp",
+			sample.text.size() / decode / (1 << 20), sample.text.size() / encode / (1 << 20));
+
+		for (int level = 0; level < 3; ++level) {
+			string_utils::set_simd_level(static_cast<string_utils::simd_level>(level));
+			if (string_utils::get_simd_level() != static_cast<string_utils::simd_level>(level))
+				continue;
+
+			decode = Measure([&] { wide = string_utils::utf8_to_u32(sample.text); }, 5);
+			encode = Measure([&] { narrow = string_utils::u32_to_utf8(wide); }, 5);
+			std::printf("%-10s %-10s %-14.1f %-14.1f\n", sample.name, levels[level],
+				sample.text.size() / decode / (1 << 20), sample.text.size() / encode / (1 << 20));
+		}
+		string_utils::set_simd_level(string_utils::simd_level::avx2);
+	}
+}
+
+static const char* usage =
+	"usage: SubstitutionCipherBench [options] [section...]\n"
+	"\n"
+	"sections: suite scaling parallel allocations transcoding (default: all)\n"
+	"  --json FILE        write the suite results to FILE as JSON\n"
+	"  --max-bytes N      largest suite input, up to 1 GB (default: 64 MB)\n"
+	"  --min-seconds S    time spent on each suite case (default: 0.2)\n";
+
+int main(int argc, char* argv[])
+{
+	SuiteOptions options;
+	std::vector<std::string_view> sections;
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg = argv[i];
+		if (arg == "--json" && i + 1 < argc)
+			options.json = argv[++i];
+		else if (arg == "--max-bytes" && i + 1 < argc)
+			options.maxBytes = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--min-seconds" && i + 1 < argc)
+			options.minSeconds = std::strtod(argv[++i], nullptr);
+		else if (arg.starts_with("-")) {
+			std::fputs(usage, stderr);
+			return 2;
+		}
+		else
+			sections.push_back(arg);
+	}
+
+	auto selected = [&](std::string_view name) {
+		return sections.empty() || std::find(sections.begin(), sections.end(), name) != sections.end();
+	};
+
+	if (selected("suite")) BenchSuite(options);
+	if (selected("scaling")) BenchDecodeScaling();
+	if (selected("parallel")) {
+		BenchParallel(KeySchedule::Legacy, "legacy");
+		BenchParallel(KeySchedule::Positional, "positional");
+	}
+	if (selected("allocations")) BenchAllocations();
+	if (selected("transcoding")) BenchTranscoding();
+
+	return 0;
+}
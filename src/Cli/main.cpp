@@ -0,0 +1,483 @@
+#include "../Core/Cipher/AlphabetIndex.hpp"
+#include "../Core/Cipher/Alphabets.hpp"
+#include "../Core/Cipher/Cipher.hpp"
+#include "../Core/MappedFile/MappedFile.hpp"
+#include "../Utils/StringUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <shellapi.h>
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+static const char* usage =
+	"usage: SubstitutionCipherCli encode|decode -k KEY [options]\n"
+	"\n"
+	"  -k, --key KEY          keyword\n"
+	"  -a, --alphabet NAME    rus (default), mixed, or the alphabet itself\n"
+	"  -s, --separator SEP    separator between symbol pairs (default: space)\n"
+	"      --schedule NAME    key schedule: legacy (default); v1, portable across platforms;\n"
+	"                         or positional, like v1 with homophones picked by text offset\n"
+	"  -i, --input FILE       read FILE instead of stdin\n"
+	"  -o, --output FILE      write FILE instead of stdout\n"
+	"  -t, --threads N        threads for file input, 0 = one per core (default: 1)\n"
+	"  -c, --chunk BYTES      read and write block size when streaming (default: 65536)\n"
+	"      --fixed            fixed-width tokens without separators; unlike -s \"\" this keeps\n"
+	"                         a trailing non-alphabet character\n"
+	"  -w, --wrap N           fixed-width tokens, N per line, that decode after any rewrapping;\n"
+	"                         when decoding N is ignored\n"
+	"      --binary           encode to / decode from the bit-packed binary form\n"
+	"      --compressed       encode to / decode from the entropy-coded form; decoding\n"
+	"                         from stdin is streamed\n"
+	"      --container        encode to / decode from the self-describing container format;\n"
+	"                         decoding then takes separator and key schedule from the input\n"
+	"      --index FILE       encode: also write a seek index of the input to FILE;\n"
+	"                         decode: use FILE to decode only the --range\n"
+	"      --interval N       code points between index checkpoints (default: 65536)\n"
+	"      --range FROM:TO    plaintext bytes [FROM, TO) to decode with --index\n"
+	"      --stats            report bytes/s and tokens/s to stderr; counting tokens\n"
+	"                         takes an extra pass over the plaintext\n"
+	"  -h, --help             show this help\n"
+	"\n"
+	"Without -i the input is streamed, so its size is not limited by memory.\n"
+	"With -i and -o and one thread the files are processed through memory mappings.\n";
+
+struct Options {
+	bool encode = true;
+	std::string key;
+	std::string alphabet = alphabets::Russian;
+	std::string separator = " ";
+	KeySchedule schedule = KeySchedule::Legacy;
+	std::optional<std::string> input;
+	std::optional<std::string> output;
+	size_t threads = 1;
+	size_t chunk = StreamEncoder::DefaultBufferSize;
+	bool fixed = false;
+	size_t wrap = 0;
+	bool binary = false;
+	bool compressed = false;
+	bool container = false;
+	std::optional<std::string> index;
+	size_t interval = SeekIndex::DefaultInterval;
+	std::optional<std::pair<uint64_t, uint64_t>> range;
+	bool stats = false;
+};
+
+// The command line as UTF-8. Windows passes argv in the ANSI code page, which cannot hold every
+// path or key, so there the arguments are taken from the UTF-16 command line instead.
+static std::vector<std::string> Arguments(int argc, char* argv[])
+{
+#ifdef _WIN32
+	(void)argc;
+	(void)argv;
+	int count = 0;
+	LPWSTR* wide = CommandLineToArgvW(GetCommandLineW(), &count);
+	if (!wide)
+		throw std::runtime_error("cannot read the command line");
+
+	std::vector<std::string> result;
+	for (int i = 0; i < count; ++i) {
+		int bytes = WideCharToMultiByte(CP_UTF8, 0, wide[i], -1, nullptr, 0, nullptr, nullptr);
+		std::string arg(bytes > 0 ? bytes - 1 : 0, '\0');
+		if (bytes > 1)
+			WideCharToMultiByte(CP_UTF8, 0, wide[i], -1, arg.data(), bytes, nullptr, nullptr);
+		result.push_back(std::move(arg));
+	}
+	LocalFree(wide);
+	return result;
+#else
+	return std::vector<std::string>(argv, argv + argc);
+#endif
+}
+
+// Paths arrive as UTF-8, like everywhere else in the application
+static std::filesystem::path ToPath(std::string const& path)
+{
+	return std::filesystem::path(string_utils::utf8_to_u32(path));
+}
+
+static size_t ParseSize(std::string_view name, std::string const& value)
+{
+	size_t end = 0;
+	unsigned long long result = 0;
+	try {
+		result = std::stoull(value, &end);
+	}
+	catch (std::exception const&) {
+	}
+	if (end == 0 || end != value.size())
+		throw std::invalid_argument(std::string(name) + ": not a number: " + value);
+	return static_cast<size_t>(result);
+}
+
+static Options ParseOptions(std::vector<std::string> const& args)
+{
+	if (args.size() < 2)
+		throw std::invalid_argument("missing command");
+
+	Options options;
+	std::string_view command = args[1];
+	if (command == "encode")
+		options.encode = true;
+	else if (command == "decode")
+		options.encode = false;
+	else
+		throw std::invalid_argument("unknown command: " + std::string(command));
+
+	bool hasKey = false;
+	for (size_t i = 2; i < args.size(); ++i) {
+		std::string_view arg = args[i];
+		auto value = [&]() -> std::string {
+			if (i + 1 >= args.size())
+				throw std::invalid_argument(std::string(arg) + ": missing value");
+			return args[++i];
+		};
+
+		if (arg == "-k" || arg == "--key") {
+			options.key = value();
+			hasKey = true;
+		}
+		else if (arg == "-a" || arg == "--alphabet") {
+			std::string name = value();
+			options.alphabet = name == "rus" ? alphabets::Russian : name == "mixed" ? alphabets::Mixed : name;
+		}
+		else if (arg == "-s" || arg == "--separator")
+			options.separator = value();
+		else if (arg == "--schedule") {
+			std::string name = value();
+			if (name == "legacy")
+				options.schedule = KeySchedule::Legacy;
+			else if (name == "v1")
+				options.schedule = KeySchedule::V1;
+			else if (name == "positional")
+				options.schedule = KeySchedule::Positional;
+			else
+				throw std::invalid_argument("unknown key schedule: " + name);
+		}
+		else if (arg == "-i" || arg == "--input")
+			options.input = value();
+		else if (arg == "-o" || arg == "--output")
+			options.output = value();
+		else if (arg == "-t" || arg == "--threads")
+			options.threads = ParseSize(arg, value());
+		else if (arg == "-c" || arg == "--chunk")
+			options.chunk = ParseSize(arg, value());
+		else if (arg == "-w" || arg == "--wrap")
+			options.wrap = ParseSize(arg, value());
+		else if (arg == "--fixed")
+			options.fixed = true;
+		else if (arg == "--binary")
+			options.binary = true;
+		else if (arg == "--compressed")
+			options.compressed = true;
+		else if (arg == "--container")
+			options.container = true;
+		else if (arg == "--index")
+			options.index = value();
+		else if (arg == "--interval")
+			options.interval = ParseSize(arg, value());
+		else if (arg == "--range") {
+			std::string range = value();
+			size_t colon = range.find(':');
+			if (colon == std::string::npos)
+				throw std::invalid_argument("--range: expected FROM:TO, got " + range);
+			options.range.emplace(ParseSize(arg, range.substr(0, colon)), ParseSize(arg, range.substr(colon + 1)));
+		}
+		else if (arg == "--stats")
+			options.stats = true;
+		else
+			throw std::invalid_argument("unknown option: " + std::string(arg));
+	}
+
+	if (!hasKey)
+		throw std::invalid_argument("missing --key");
+	if (options.alphabet.empty())
+		throw std::invalid_argument("empty alphabet");
+	if (options.fixed + (options.wrap != 0) + options.binary + options.compressed + options.container > 1)
+		throw std::invalid_argument("--fixed, --wrap, --binary, --compressed and --container exclude each other");
+	if (options.chunk == 0)
+		throw std::invalid_argument("--chunk must be positive");
+	if (options.index && (options.fixed || options.wrap || options.binary || options.compressed || options.container))
+		throw std::invalid_argument("--index works on the text form only");
+	if (options.index && !options.input)
+		throw std::invalid_argument("--index needs --input");
+	if (options.index && !options.encode && !options.range)
+		throw std::invalid_argument("decoding with --index needs --range");
+	if (options.range && (options.encode || !options.index))
+		throw std::invalid_argument("--range decodes with --index only");
+	if (options.interval == 0)
+		throw std::invalid_argument("--interval must be positive");
+	return options;
+}
+
+// Counts plaintext code points found in the alphabet, one token each, over text arriving in pieces
+class TokenCounter
+{
+	AlphabetIndex m_alphabet;
+	std::string m_pending;
+	size_t m_tokens = 0;
+
+	void Count(const char* it, const char* end) {
+		while (it != end)
+			if (m_alphabet.Contains(string_utils::next_code_point(it, end)))
+				m_tokens++;
+	}
+public:
+	explicit TokenCounter(std::string const& alphabet) : m_alphabet(string_utils::utf8_to_u32(alphabet)) {}
+
+	void Add(std::string_view text) {
+		const char* it = text.data();
+		const char* end = it + text.size();
+
+		while (!m_pending.empty() && it != end) {
+			m_pending += *it++;
+			if (m_pending.size() == string_utils::utf8_sequence_length(static_cast<unsigned char>(m_pending[0]))) {
+				Count(m_pending.data(), m_pending.data() + m_pending.size());
+				m_pending.clear();
+			}
+		}
+
+		const char* whole = end - string_utils::incomplete_utf8_suffix(it, end);
+		Count(it, whole);
+		m_pending.assign(whole, end);
+	}
+
+	size_t GetTokens() const { return m_tokens; }
+};
+
+struct Totals {
+	size_t input = 0;
+	size_t output = 0;
+};
+
+static void WriteAll(std::FILE* file, std::string_view data)
+{
+	if (std::fwrite(data.data(), 1, data.size(), file) != data.size())
+		throw std::runtime_error("write failed");
+}
+
+// Input from a file: mapped whole and processed by the parallel paths, or file to file by Cipher::EncodeFile
+static Totals ProcessFile(Options const& options, Cipher& cipher, TokenCounter* tokens)
+{
+	std::filesystem::path input = ToPath(*options.input);
+	Totals totals;
+
+	if (options.output && options.threads == 1) {
+		totals.output = options.encode
+			? cipher.EncodeFile(input, ToPath(*options.output), options.key)
+			: cipher.DecodeFile(input, ToPath(*options.output), options.key);
+		totals.input = std::filesystem::file_size(input);
+		if (tokens && options.encode)
+			tokens->Add(MappedFile::OpenRead(input).View());
+		else if (tokens)
+			tokens->Add(MappedFile::OpenRead(ToPath(*options.output)).View());
+		return totals;
+	}
+
+	MappedFile source = MappedFile::OpenRead(input);
+	std::string result = options.encode
+		? cipher.EncodeParallel(source.View(), options.key, options.threads)
+		: cipher.DecodeParallel(source.View(), options.key, options.threads);
+	totals.input = source.Size();
+	totals.output = result.size();
+	if (tokens)
+		tokens->Add(options.encode ? source.View() : std::string_view(result));
+
+	if (options.output) {
+		MappedFile target = MappedFile::Create(ToPath(*options.output), result.size());
+		std::copy(result.begin(), result.end(), target.Span().begin());
+		target.Close();
+	}
+	else
+		WriteAll(stdout, result);
+	return totals;
+}
+
+// Fixed-width, wrapped, container, binary and compressed form need the whole input at once: a mapped file, or stdin read to its end
+static Totals ProcessWhole(Options const& options, Cipher& cipher, TokenCounter* tokens)
+{
+	std::optional<MappedFile> source;
+	std::string buffered;
+	std::string_view input;
+	if (options.input) {
+		source = MappedFile::OpenRead(ToPath(*options.input));
+		input = source->View();
+	}
+	else {
+		std::string buffer(options.chunk, '\0');
+		while (size_t read = std::fread(buffer.data(), 1, buffer.size(), stdin))
+			buffered.append(buffer.data(), read);
+		if (std::ferror(stdin))
+			throw std::runtime_error("read failed");
+		input = buffered;
+	}
+
+	std::string result;
+	if (options.fixed)
+		result = options.encode ? cipher.EncodeFixed(input, options.key) : cipher.DecodeFixed(input, options.key);
+	else if (options.wrap)
+		result = options.encode ? cipher.EncodeWrapped(input, options.key, options.wrap) : cipher.DecodeWrapped(input, options.key);
+	else if (options.container)
+		result = options.encode ? cipher.EncodeContainer(input, options.key) : cipher.DecodeContainer(input, options.key);
+	else if (options.compressed)
+		result = options.encode ? cipher.EncodeCompressed(input, options.key) : cipher.DecodeCompressed(input, options.key);
+	else
+		result = options.encode ? cipher.EncodeBinary(input, options.key) : cipher.DecodeBinary(input, options.key);
+	if (tokens)
+		tokens->Add(options.encode ? input : std::string_view(result));
+
+	if (options.output) {
+		std::ofstream file(ToPath(*options.output), std::ios::binary);
+		if (!file || !file.write(result.data(), result.size()))
+			throw std::runtime_error("cannot write output file: " + *options.output);
+	}
+	else
+		WriteAll(stdout, result);
+	return { input.size(), result.size() };
+}
+
+// Only the --range of the plaintext, decoded from the checkpoint before it on
+static Totals ProcessRange(Options const& options, Cipher& cipher, TokenCounter* tokens)
+{
+	MappedFile index = MappedFile::OpenRead(ToPath(*options.index));
+	MappedFile source = MappedFile::OpenRead(ToPath(*options.input));
+	std::string result = cipher.DecodeSlice(source.View(), options.key, SeekIndex::Parse(index.View()),
+		options.range->first, options.range->second);
+	if (tokens)
+		tokens->Add(result);
+
+	if (options.output) {
+		std::ofstream file(ToPath(*options.output), std::ios::binary);
+		if (!file || !file.write(result.data(), result.size()))
+			throw std::runtime_error("cannot write output file: " + *options.output);
+	}
+	else
+		WriteAll(stdout, result);
+	return { result.size(), result.size() };
+}
+
+static void WriteIndex(Options const& options, Cipher& cipher)
+{
+	MappedFile source = MappedFile::OpenRead(ToPath(*options.input));
+	std::string index = cipher.BuildIndex(source.View(), options.key, options.interval).Serialize();
+	std::ofstream file(ToPath(*options.index), std::ios::binary);
+	if (!file || !file.write(index.data(), index.size()))
+		throw std::runtime_error("cannot write index file: " + *options.index);
+}
+
+// Input from stdin: read in chunks and streamed, so memory use does not depend on the input size
+static Totals ProcessStream(Options const& options, Cipher& cipher, TokenCounter* tokens)
+{
+	std::FILE* out = stdout;
+	std::ofstream file;
+	if (options.output) {
+		file.open(ToPath(*options.output), std::ios::binary);
+		if (!file)
+			throw std::runtime_error("cannot open output file: " + *options.output);
+	}
+
+	Totals totals;
+	auto sink = [&](std::string_view data) {
+		totals.output += data.size();
+		if (tokens && !options.encode)
+			tokens->Add(data);
+		if (options.output) {
+			if (!file.write(data.data(), data.size()))
+				throw std::runtime_error("write failed");
+		}
+		else
+			WriteAll(out, data);
+	};
+
+	auto run = [&](auto&& stream) {
+		std::string buffer(options.chunk, '\0');
+		while (size_t read = std::fread(buffer.data(), 1, buffer.size(), stdin)) {
+			std::string_view chunk(buffer.data(), read);
+			totals.input += read;
+			if (tokens && options.encode)
+				tokens->Add(chunk);
+			stream.Write(chunk);
+		}
+		if (std::ferror(stdin))
+			throw std::runtime_error("read failed");
+		stream.Finish();
+	};
+
+	if (options.compressed)
+		run(cipher.CreateCompressedDecoder(options.key, sink));
+	else if (options.encode)
+		run(StreamEncoder(cipher.Prepare(options.key), sink, options.chunk));
+	else
+		run(StreamDecoder(cipher.Prepare(options.key), sink, options.chunk));
+	return totals;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc >= 2 && (std::string_view(argv[1]) == "-h" || std::string_view(argv[1]) == "--help")) {
+		std::fputs(usage, stdout);
+		return 0;
+	}
+
+#ifdef _WIN32
+	_setmode(_fileno(stdin), _O_BINARY);
+	_setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+	Options options;
+	try {
+		options = ParseOptions(Arguments(argc, argv));
+	}
+	catch (std::exception const& e) {
+		std::fprintf(stderr, "error: %s\n\n%s", e.what(), usage);
+		return 2;
+	}
+
+	try {
+		Cipher cipher(options.alphabet, options.separator, options.schedule);
+		std::optional<TokenCounter> tokens;
+		if (options.stats)
+			tokens.emplace(options.alphabet);
+
+		auto start = std::chrono::steady_clock::now();
+		TokenCounter* counter = tokens ? &*tokens : nullptr;
+		bool whole = options.fixed || options.wrap || options.container || options.binary ||
+			(options.compressed && (options.encode || options.input));
+		Totals totals = options.range ? ProcessRange(options, cipher, counter)
+			: whole ? ProcessWhole(options, cipher, counter)
+			: options.input ? ProcessFile(options, cipher, counter)
+			: ProcessStream(options, cipher, counter);
+		if (options.index && options.encode)
+			WriteIndex(options, cipher);
+		std::fflush(stdout);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (options.stats) {
+			seconds = std::max(seconds, 1e-9);
+			std::fprintf(stderr, "input %zu bytes, output %zu bytes, %zu tokens in %.3f s\n",
+				totals.input, totals.output, tokens->GetTokens(), seconds);
+			std::fprintf(stderr, "%.1f MB/s, %.0f tokens/s\n",
+				totals.input / seconds / (1 << 20), tokens->GetTokens() / seconds);
+		}
+	}
+	catch (std::exception const& e) {
+		std::fprintf(stderr, "error: %s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
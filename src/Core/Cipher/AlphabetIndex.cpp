@@ -0,0 +1,55 @@
+#include "AlphabetIndex.hpp"
+
+#include <bit>
+
+AlphabetIndex::AlphabetIndex()
+{
+	m_direct.fill(NotFound);
+}
+
+AlphabetIndex::AlphabetIndex(std::u32string symbols) : m_symbols(std::move(symbols))
+{
+	m_direct.fill(NotFound);
+
+	size_t wide = 0;
+	for (auto c : m_symbols)
+		if (c >= DirectRange) wide++;
+
+	if (wide) {
+		m_slots.assign(std::bit_ceil(wide * 2), { EmptySlot, NotFound });
+		m_mask = m_slots.size() - 1;
+	}
+
+	for (size_t i = 0; i < m_symbols.size(); ++i) {
+		char32_t c = m_symbols[i];
+		if (c < DirectRange) {
+			if (m_direct[c] == NotFound) m_direct[c] = static_cast<uint32_t>(i);
+			continue;
+		}
+
+		size_t slot = (c * 0x9E3779B1u) & m_mask;
+		while (m_slots[slot].symbol != EmptySlot && m_slots[slot].symbol != c)
+			slot = (slot + 1) & m_mask;
+
+		if (m_slots[slot].symbol == EmptySlot)
+			m_slots[slot] = { c, static_cast<uint32_t>(i) };
+	}
+}
+
+uint32_t AlphabetIndex::FindSlow(char32_t c) const
+{
+	if (m_slots.empty()) return NotFound;
+
+	size_t slot = (c * 0x9E3779B1u) & m_mask;
+	while (m_slots[slot].symbol != EmptySlot) {
+		if (m_slots[slot].symbol == c) return m_slots[slot].position;
+		slot = (slot + 1) & m_mask;
+	}
+	return NotFound;
+}
+
+size_t AlphabetIndex::MemoryUsage() const
+{
+	return sizeof(AlphabetIndex) + m_symbols.capacity() * sizeof(char32_t) +
+		m_slots.capacity() * sizeof(Slot);
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Constant-time symbol -> alphabet position lookup.
+// ASCII, Latin-1 and Cyrillic code points are resolved through a direct table,
+// everything else through a small open-addressing hash table.
+class AlphabetIndex
+{
+public:
+	static constexpr uint32_t NotFound = UINT32_MAX;
+	static constexpr char32_t DirectRange = 0x500;
+
+private:
+	struct Slot {
+		char32_t symbol;
+		uint32_t position;
+	};
+
+	static constexpr char32_t EmptySlot = static_cast<char32_t>(-1);
+
+	std::u32string						m_symbols;
+	std::array<uint32_t, DirectRange>	m_direct;
+	std::vector<Slot>					m_slots;
+	size_t								m_mask = 0;
+
+	uint32_t FindSlow(char32_t c) const;
+public:
+	AlphabetIndex();
+	explicit AlphabetIndex(std::u32string symbols);
+
+	// Position of the first occurrence of c, or NotFound
+	uint32_t Find(char32_t c) const {
+		return c < DirectRange ? m_direct[c] : FindSlow(c);
+	}
+
+	bool Contains(char32_t c) const { return Find(c) != NotFound; }
+	// Positions of the code points below DirectRange, NotFound for those outside the alphabet
+	std::array<uint32_t, DirectRange> const& DirectTable() const { return m_direct; }
+
+	size_t Size() const { return m_symbols.size(); }
+	char32_t operator[](size_t position) const { return m_symbols[position]; }
+	std::u32string const& Symbols() const { return m_symbols; }
+
+	size_t MemoryUsage() const;
+};
\ No newline at end of file
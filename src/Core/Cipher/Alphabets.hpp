@@ -0,0 +1,12 @@
+#pragma once
+
+// Alphabets offered by the GUI and the command-line tool
+namespace alphabets
+{
+	inline constexpr const char* Russian = "АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ";
+	inline constexpr const char* Mixed = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+										"abcdefghijklmnopqrstuvwxyz"
+										"АБВГДЕЁЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯ"
+										"абвгдеёжзийклмнопрстуфхцчшщъыьэюя"
+										"0123456789 .,!?-:;()\"'";
+}
@@ -0,0 +1,195 @@
+#include "BinaryFormat.hpp"
+#include "BitStream.hpp"
+#include "../../Utils/StringUtils.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+namespace
+{
+	void PutHeader(std::string& out, uint64_t codes)
+	{
+		for (size_t i = 0; i < BinaryFormat::HeaderSize; ++i)
+			out[i] = static_cast<char>(codes >> (8 * i));
+	}
+
+	uint64_t ReadHeader(std::string_view data, unsigned bits)
+	{
+		if (data.size() < BinaryFormat::HeaderSize)
+			throw std::invalid_argument("BinaryFormat: missing header");
+
+		uint64_t codes = 0;
+		for (size_t i = 0; i < BinaryFormat::HeaderSize; ++i)
+			codes |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+
+		if (codes > (data.size() - BinaryFormat::HeaderSize) * 8 / bits)
+			throw std::invalid_argument("BinaryFormat: truncated data");
+		return codes;
+	}
+
+	// Calls token(code, i) or passthrough(code point, i) for code i, in order
+	template <class Token, class Passthrough>
+	void ReadCodes(std::string_view data, unsigned bits, uint32_t escape, Token&& token, Passthrough&& passthrough)
+	{
+		uint64_t codes = ReadHeader(data, bits);
+		BitReader reader(data.data() + BinaryFormat::HeaderSize, data.size() - BinaryFormat::HeaderSize);
+		uint32_t mask = (1u << bits) - 1;
+		constexpr unsigned WordBits = 57;
+
+		// Takes as many codes from each word as it holds whole
+		uint64_t i = 0;
+		while (i < codes) {
+			uint64_t word = reader.Peek();
+			unsigned used = 0;
+			while (i < codes && used + bits <= WordBits) {
+				uint32_t code = static_cast<uint32_t>(word >> used) & mask;
+				if (code < escape) {
+					token(code, i);
+					used += bits;
+				}
+				else if (code == escape) {
+					if (used + bits + BinaryFormat::CodePointBits > WordBits)
+						break;
+					char32_t c = static_cast<char32_t>(word >> (used + bits)) & ((1u << BinaryFormat::CodePointBits) - 1);
+					if (c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+						throw std::invalid_argument("BinaryFormat: invalid code point");
+					passthrough(c, i);
+					used += bits + BinaryFormat::CodePointBits;
+				}
+				else
+					throw std::invalid_argument("BinaryFormat: invalid token code");
+				++i;
+			}
+
+			if (used > reader.Remaining())
+				throw std::invalid_argument("BinaryFormat: truncated data");
+			reader.Skip(used);
+		}
+	}
+}
+
+unsigned BinaryFormat::CodeBits(PreparedKey const& key)
+{
+	return static_cast<unsigned>(std::bit_width(key.m_table.tokens.size()));
+}
+
+std::string BinaryFormat::Encode(PreparedKey const& key, std::string_view text)
+{
+	auto const& table = key.m_table;
+	unsigned bits = CodeBits(key);
+	uint32_t escape = static_cast<uint32_t>(table.tokens.size());
+	std::vector<size_t> counters(key.m_alphabet.Size(), 0);
+
+	std::string result(HeaderSize, '\0');
+	result.reserve(HeaderSize + text.size());
+	BitWriter writer(result);
+	uint64_t codes = 0;
+
+	const char* it = text.data();
+	const char* end = it + text.size();
+	while (it != end) {
+		const char* start = it;
+		char32_t c = string_utils::next_code_point(it, end);
+		uint32_t pos = key.m_alphabet.Find(c);
+		if (pos == AlphabetIndex::NotFound) {
+			writer.Put(escape, bits);
+			writer.Put(c, CodePointBits);
+		}
+		else {
+			// The homophone Encode would pick
+			writer.Put(static_cast<uint32_t>(key.PickToken(pos, counters.data(), start - text.data())), bits);
+		}
+		codes++;
+	}
+
+	writer.Flush();
+	PutHeader(result, codes);
+	return result;
+}
+
+std::string BinaryFormat::Decode(PreparedKey const& key, std::string_view data)
+{
+	auto const& table = key.m_table;
+	unsigned bits = CodeBits(key);
+	uint64_t codes = ReadHeader(data, bits);
+
+	// Every code yields at most one code point
+	std::string result(codes * 4, '\0');
+	char* out = result.data();
+	ReadCodes(data, bits, static_cast<uint32_t>(table.tokens.size()),
+		[&](uint32_t code, uint64_t) {
+			char32_t symbol = table.tokenSymbols[code];
+			if (symbol != PreparedKey::NoSymbol)
+				out = string_utils::write_utf8(out, symbol);
+		},
+		[&](char32_t c, uint64_t i) {
+			// Decode never emits the last code point of the text, which here is a passthrough one
+			if (i + 1 < codes)
+				out = string_utils::write_utf8(out, c);
+		});
+
+	result.resize(out - result.data());
+	return result;
+}
+
+std::string BinaryFormat::Pack(PreparedKey const& key, std::string_view ciphertext)
+{
+	auto const& table = key.m_table;
+	auto const& alphabet = key.m_alphabet;
+	size_t size = alphabet.Size();
+	unsigned bits = CodeBits(key);
+	uint32_t escape = static_cast<uint32_t>(table.tokens.size());
+
+	// Any homophone with the right pair unpacks to the same text
+	std::vector<uint32_t> pairToken(size * size, escape);
+	for (uint32_t t = 0; t < escape; ++t) {
+		auto& slot = pairToken[alphabet.Find(table.tokens[t][0]) * size + alphabet.Find(table.tokens[t][1])];
+		if (slot == escape) slot = t;
+	}
+
+	std::string result(HeaderSize, '\0');
+	result.reserve(HeaderSize + ciphertext.size() / 3);
+	BitWriter writer(result);
+	uint64_t codes = 0;
+
+	const char* it = ciphertext.data();
+	const char* end = it + ciphertext.size();
+	while (it != end) {
+		char32_t c = string_utils::next_code_point(it, end);
+		uint32_t first = alphabet.Find(c);
+		codes++;
+		if (first == AlphabetIndex::NotFound) {
+			writer.Put(escape, bits);
+			writer.Put(c, CodePointBits);
+			continue;
+		}
+
+		uint32_t second = it == end ? AlphabetIndex::NotFound : alphabet.Find(string_utils::next_code_point(it, end));
+		uint32_t token = second == AlphabetIndex::NotFound ? escape : pairToken[first * size + second];
+		if (token == escape)
+			throw std::invalid_argument("BinaryFormat: not a token of this key");
+		writer.Put(token, bits);
+
+		for (char32_t s : key.m_separator)
+			if (it == end || string_utils::next_code_point(it, end) != s)
+				throw std::invalid_argument("BinaryFormat: separator does not match the key");
+	}
+
+	writer.Flush();
+	PutHeader(result, codes);
+	return result;
+}
+
+std::string BinaryFormat::Unpack(PreparedKey const& key, std::string_view data)
+{
+	auto const& table = key.m_table;
+	std::string result;
+	result.reserve(data.size() * 3);
+	ReadCodes(data, CodeBits(key), static_cast<uint32_t>(table.tokens.size()),
+		[&](uint32_t code, uint64_t) {
+			result.append(table.tokenBytes.data() + table.tokenOffsets[code],
+				table.tokenBytes.data() + table.tokenOffsets[code + 1]);
+		},
+		[&](char32_t c, uint64_t) { string_utils::append_utf8(result, c); });
+	return result;
+}
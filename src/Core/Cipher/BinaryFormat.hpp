@@ -0,0 +1,35 @@
+#pragma once
+#include "PreparedKey.hpp"
+
+#include <string>
+#include <string_view>
+
+// Compact form of a ciphertext: every token is stored as its index among the key's homophones
+// (PreparedKey's token list), bit-packed at w = bit_width(tokens) bits, so one symbol takes
+// w bits instead of two alphabet code points and the separator.
+// Layout: u64 little-endian count of codes, then the codes, least significant bit first.
+// Code `tokens` is an escape followed by a passthrough code point in 21 bits.
+// Unpack(Encode(text)) == PreparedKey::Encode(text), and Unpack reverses Pack. Pack reverses
+// Unpack only where no two homophones are the same pair of code points: Pack stores the first
+// token with that text, which decodes to the same plaintext but may be a different code. That
+// happens in small alphabets whose row or column keys repeat symbols.
+class BinaryFormat
+{
+public:
+	static constexpr size_t HeaderSize = 8;
+	static constexpr unsigned CodePointBits = 21;
+
+	static std::string Encode(PreparedKey const& key, std::string_view text);
+	// Same result as PreparedKey::Decode(Unpack(key, data)), including the dropped last
+	// code point when it is a passthrough one. Throws std::invalid_argument on malformed data.
+	static std::string Decode(PreparedKey const& key, std::string_view data);
+
+	// Textual ciphertext to binary; throws std::invalid_argument if text is not exactly
+	// what Encode produces for this key, e.g. a different separator
+	static std::string Pack(PreparedKey const& key, std::string_view ciphertext);
+	// Binary to the textual ciphertext
+	static std::string Unpack(PreparedKey const& key, std::string_view data);
+
+	// Bits per token code for key
+	static unsigned CodeBits(PreparedKey const& key);
+};
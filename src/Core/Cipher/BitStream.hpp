@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Bit-level I/O for the packed ciphertext forms (BinaryFormat, CompressedFormat)
+
+// Appends codes least significant bit first
+class BitWriter
+{
+	std::string& m_out;
+	uint64_t m_bits = 0;
+	unsigned m_count = 0;
+public:
+	explicit BitWriter(std::string& out) : m_out(out) {}
+
+	// bits <= 32
+	void Put(uint32_t value, unsigned bits) {
+		m_bits |= static_cast<uint64_t>(value) << m_count;
+		m_count += bits;
+		if (m_count >= 32) {
+			char bytes[4] = { static_cast<char>(m_bits), static_cast<char>(m_bits >> 8),
+				static_cast<char>(m_bits >> 16), static_cast<char>(m_bits >> 24) };
+			m_out.append(bytes, 4);
+			m_bits >>= 32;
+			m_count -= 32;
+		}
+	}
+
+	void Flush() {
+		for (; m_count > 0; m_count = m_count > 8 ? m_count - 8 : 0, m_bits >>= 8)
+			m_out += static_cast<char>(m_bits);
+	}
+};
+
+// Reads whole 64-bit words; after Peek at least 57 bits are valid, zeros past the end
+class BitReader
+{
+	const char* m_data;
+	size_t m_size;
+	size_t m_bit = 0;
+public:
+	BitReader(const char* data, size_t size) : m_data(data), m_size(size) {}
+
+	uint64_t Peek() const {
+		size_t byte = m_bit >> 3;
+		uint64_t word = 0;
+		if (byte + 8 <= m_size) {
+			std::memcpy(&word, m_data + byte, 8);	// little-endian, as on every platform this builds for
+		}
+		else {
+			for (size_t i = 0; byte + i < m_size; ++i)
+				word |= static_cast<uint64_t>(static_cast<unsigned char>(m_data[byte + i])) << (8 * i);
+		}
+		return word >> (m_bit & 7);
+	}
+
+	void Skip(size_t bits) { m_bit += bits; }
+	size_t Remaining() const { return m_size * 8 - std::min(m_bit, m_size * 8); }
+};
@@ -1,203 +1,354 @@
-#include "Cipher.hpp"
-#include "../../Utils/StringUtils.hpp"
-
-#include <random>
-#include <algorithm>
-#include <unordered_map>
-#include <span>
-#include <ranges>
-
-
-
-Cipher::Cipher(std::string const& alphabet, std::string const& separator)
-{
-	m_alphabet = string_utils::utf8_to_u32(alphabet);
-	m_separator = string_utils::utf8_to_u32(separator);
-}
-
-Cipher::Table Cipher::BuildTable(std::u32string const& key) 
-{
-	std::u32string base = key;
-	for (auto c : m_alphabet)
-		if (base.find(c) == std::u32string::npos)
-			base += c;
-
-	int total = static_cast<int>(base.size());
-	int cols = static_cast<int>(ceil(sqrt(total)));
-	int rows = static_cast<int>(ceil(static_cast<double>(total) / cols));
-
-	Cipher::Table table{
-		std::vector<std::vector<char32_t>>(rows, std::vector<char32_t>(cols, U'\0')),
-		std::vector<std::u32string>(rows),
-		std::vector<std::u32string>(cols)
-	};
-
-	int k = 0;
-	for (int i = 0; i < rows && k < total; i++)
-		for (int j = 0; j < cols && k < total; j++)
-			table.table[i][j] = base[k++];
-
-	auto generateTableKeys = [&](const std::u32string& key, int count,
-                             std::span<const char32_t> symbols) -> std::vector<std::u32string>
-	{
-		uint64_t seed = string_utils::str_hash(key);
-		std::mt19937_64 rng(seed);
-
-		std::vector<char32_t> local_symbols(symbols.begin(), symbols.end());
-		std::shuffle(local_symbols.begin(), local_symbols.end(), rng);
-
-		std::vector<std::u32string> res;
-		res.reserve(count);
-
-		size_t idx = 0;
-		for (int i = 0; i < count; ++i) {
-			char32_t a = local_symbols[idx++];
-			char32_t b = local_symbols[idx++];
-			res.emplace_back(std::u32string{a, b});
-
-			if (idx + 1 >= local_symbols.size()) {
-				std::shuffle(local_symbols.begin(), local_symbols.end(), rng);
-				idx = 0;
-			}
-		}
-
-		return res;
-	};
-	uint64_t seed = string_utils::str_hash(key);
-	std::mt19937_64 rng(seed);
-	std::vector<char32_t> symbols(m_alphabet.begin(), m_alphabet.end());
-	std::shuffle(symbols.begin(), symbols.end(), rng);
-	size_t half = symbols.size() / 2;
-
-	std::span<const char32_t> row_symbols(symbols.data(), half);
-	std::span<const char32_t> col_symbols(symbols.data() + half, symbols.size() - half);
-
-	table.rowKeys = generateTableKeys(key, rows, row_symbols);
-	table.colKeys = generateTableKeys(key + U"_col", cols, col_symbols);
-
-
-	return table;
-}
-
-std::u32string Cipher::GetUniqueKey(std::u32string const& key)
-{
-	std::u32string res;
-	for (auto c : key) {
-		if (res.find(c) == std::u32string::npos && m_alphabet.find(c) != std::u32string::npos) {
-			res += c;
-		}
-	}
-	return res;
-}
-
-std::string Cipher::Encode(std::string const& oText, std::string const& oKeyword)
-{
-	std::u32string key = string_utils::utf8_to_u32(oKeyword);
-	std::u32string text = string_utils::utf8_to_u32(oText);
-
-	auto table = BuildTable(GetUniqueKey(key));
-
-	std::u32string result;
-	std::unordered_map<char32_t, int> counters;
-	for (auto c : text) {
-		if (m_alphabet.find(c) == std::u32string::npos) {
-			result += c;
-			continue;
-		}
-
-		std::vector<std::u32string> combos;
-
-		for (size_t i = 0; i < table.table.size(); ++i) {
-			for (size_t j = 0; j < table.table[i].size(); ++j) {
-				if (table.table[i][j] == c) {
-					const auto& r = table.rowKeys[i];
-					const auto& col = table.colKeys[j];
-
-					for (auto rc : r)
-						for (auto cc : col) {
-							combos.push_back({ rc, cc });
-							combos.push_back({ cc, rc });
-						}
-				}
-			}
-		}
-
-		uint64_t seed = string_utils::str_hash(key + std::u32string(1, c));
-		std::mt19937_64 rng(seed);
-		std::shuffle(combos.begin(), combos.end(), rng);
-
-		int index = counters[c] % combos.size();
-		std::u32string chosen = combos[index];
-		counters[c]++;
-		for (auto ch : chosen) result += ch;
-		result += m_separator;
-	}
-
-	return string_utils::u32_to_utf8(result);
-}
-
-std::string Cipher::Decode(std::string const& oText, std::string const& oKeyword)
-{
-	std::u32string key = string_utils::utf8_to_u32(oKeyword);
-	std::u32string text = string_utils::utf8_to_u32(oText);
-
-	auto table = BuildTable(GetUniqueKey(key));
-
-	std::u32string result;
-	for (size_t i = 0; i + 1 < text.size(); i += 2 + m_separator.length()) {
-		while (m_alphabet.find(text[i]) == std::u32string::npos && i + 1 < text.size()) {
-			result += text[i];
-			i++;
-		}
-		std::u32string token;
-		token = text[i];
-		token += text[i + 1];
-
-		bool found = false;
-		for (int j = 0; j < table.table.size() && !found; j++) {
-			for (int k = 0; k < table.table[j].size() && !found; k++) {
-				const std::u32string& r = table.rowKeys[j];
-				const std::u32string& col = table.colKeys[k];
-
-				std::vector<std::u32string> combos;
-				for (char32_t rc : r) {
-					for (char32_t cc : col) {
-						combos.push_back({ rc, cc });
-						combos.push_back({ cc, rc });
-					}
-				}
-
-				for (auto const& candidate : combos) {
-					if (candidate == token) {
-						result.push_back(table.table[j][k]);
-						found = true;
-						break;
-					}
-				}
-			}
-		}
-	}
-
-	return string_utils::u32_to_utf8(result);
-}
-
-std::string Cipher::GetAlphabet() const
-{
-	return string_utils::u32_to_utf8(m_alphabet);
-}
-
-void Cipher::SetAlphabet(std::string const& alphabet)
-{
-	m_alphabet = string_utils::utf8_to_u32(alphabet);
-}
-
-
-std::string Cipher::GetSeparator() const
-{
-	return string_utils::u32_to_utf8(m_separator);
-}
-
-void Cipher::SetSeparator(std::string const& separator)
-{
-	m_separator = string_utils::utf8_to_u32(separator);
-}
+#include "Cipher.hpp"
+#include "../MappedFile/MappedFile.hpp"
+#include "../../Utils/Parallel.hpp"
+#include "../../Utils/StringUtils.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+
+Cipher::Cipher(std::string const& alphabet, std::string const& separator, KeySchedule schedule)
+	: m_schedule(schedule), m_cache(DefaultCacheBudget)
+{
+	m_alphabet = AlphabetIndex(string_utils::utf8_to_u32(alphabet));
+	m_separator = string_utils::utf8_to_u32(separator);
+}
+
+std::shared_ptr<const PreparedKey> Cipher::Prepare(std::string_view keyword, std::pmr::memory_resource* resource)
+{
+	return Prepare(keyword, m_separator, m_schedule, resource);
+}
+
+std::shared_ptr<const PreparedKey> Cipher::Prepare(std::string_view keyword, std::u32string_view separator,
+	KeySchedule schedule, std::pmr::memory_resource* resource)
+{
+	std::pmr::u32string key = string_utils::utf8_to_u32(keyword, resource);
+
+	return m_cache.GetOrBuild({ m_alphabet.Symbols(), separator, key, static_cast<uint32_t>(schedule) }, [&] {
+		return std::make_shared<const PreparedKey>(m_alphabet, std::u32string(separator), std::u32string(key), schedule);
+	});
+}
+
+std::string Cipher::Encode(std::string_view text, std::string const& keyword)
+{
+	return Prepare(keyword)->Encode(text);
+}
+
+std::string Cipher::Decode(std::string_view text, std::string const& keyword)
+{
+	return Prepare(keyword)->Decode(text);
+}
+
+std::string Cipher::EncodeParallel(std::string_view text, std::string const& keyword, size_t threads)
+{
+	return Prepare(keyword)->EncodeParallel(text, threads);
+}
+
+std::string Cipher::DecodeParallel(std::string_view text, std::string const& keyword, size_t threads)
+{
+	return Prepare(keyword)->DecodeParallel(text, threads);
+}
+
+void Cipher::RunBatch(std::span<const BatchJob> jobs, BatchResult& out, size_t threads, bool encode)
+{
+	size_t count = jobs.size();
+	out.offsets.assign(count + 1, 0);
+	out.data.clear();
+	if (count == 0)
+		return;
+
+	// Number the distinct keywords and order the jobs by keyword, keeping their relative order
+	std::unordered_map<std::string_view, size_t> groupOf;
+	std::vector<std::string_view> keywords;
+	std::vector<size_t> jobGroup(count);
+	size_t totalBytes = 0;
+	for (size_t i = 0; i < count; ++i) {
+		auto [it, inserted] = groupOf.try_emplace(jobs[i].keyword, keywords.size());
+		if (inserted)
+			keywords.push_back(jobs[i].keyword);
+		jobGroup[i] = it->second;
+		totalBytes += jobs[i].text.size();
+	}
+
+	std::vector<size_t> order(count);
+	{
+		std::vector<size_t> groupStart(keywords.size() + 1, 0);
+		for (size_t group : jobGroup)
+			groupStart[group + 1]++;
+		for (size_t g = 0; g < keywords.size(); ++g)
+			groupStart[g + 1] += groupStart[g];
+		for (size_t i = 0; i < count; ++i)
+			order[groupStart[jobGroup[i]]++] = i;
+	}
+
+	// Work units are runs of the ordered jobs worth about BatchUnitSize bytes of input,
+	// so a thread mostly stays on one key table
+	std::vector<size_t> unitEnds;
+	for (size_t i = 0, bytes = 0; i < count; ++i) {
+		bytes += jobs[order[i]].text.size() + 1;
+		if (bytes >= BatchUnitSize || i + 1 == count) {
+			unitEnds.push_back(i + 1);
+			bytes = 0;
+		}
+	}
+	if (totalBytes < BatchUnitSize)
+		threads = 1;
+
+	std::vector<std::shared_ptr<const PreparedKey>> keys(keywords.size());
+	parallel::for_each(keywords.size(), threads, [&](size_t g) { keys[g] = Prepare(keywords[g]); });
+
+	auto forEachUnit = [&](auto&& f) {
+		parallel::for_each(unitEnds.size(), threads, [&](size_t u) {
+			for (size_t i = u == 0 ? 0 : unitEnds[u - 1]; i < unitEnds[u]; ++i)
+				f(order[i], *keys[jobGroup[order[i]]]);
+		});
+	};
+
+	std::vector<size_t>& offsets = out.offsets;
+	if (encode) {
+		// Exact sizes first, then every result is written in place
+		std::vector<size_t> sizes(count);
+		forEachUnit([&](size_t job, PreparedKey const& key) { sizes[job] = key.EncodedSize(jobs[job].text); });
+		for (size_t i = 0; i < count; ++i)
+			offsets[i + 1] = offsets[i] + sizes[i];
+
+		out.data.resize(offsets[count]);
+		forEachUnit([&](size_t job, PreparedKey const& key) {
+			key.WriteEncoded(jobs[job].text, out.data.data() + offsets[job], std::pmr::get_default_resource());
+		});
+		return;
+	}
+
+	// Decoded sizes are not known without decoding, so every result gets room for its bound
+	// and the results are moved together afterwards
+	std::vector<size_t> bounds(count + 1, 0);
+	for (size_t i = 0; i < count; ++i)
+		bounds[i + 1] = bounds[i] + keys[jobGroup[i]]->DecodedSizeBound(jobs[i].text);
+
+	std::vector<size_t> sizes(count);
+	out.data.resize(bounds[count]);
+	forEachUnit([&](size_t job, PreparedKey const& key) {
+		sizes[job] = key.Decode(jobs[job].text, std::span<char>(out.data.data() + bounds[job], bounds[job + 1] - bounds[job]));
+	});
+
+	for (size_t i = 0; i < count; ++i) {
+		offsets[i + 1] = offsets[i] + sizes[i];
+		std::memmove(out.data.data() + offsets[i], out.data.data() + bounds[i], sizes[i]);
+	}
+	out.data.resize(offsets[count]);
+}
+
+Cipher::BatchResult Cipher::EncodeBatch(std::span<const BatchJob> jobs, size_t threads)
+{
+	BatchResult result;
+	RunBatch(jobs, result, threads, true);
+	return result;
+}
+
+Cipher::BatchResult Cipher::DecodeBatch(std::span<const BatchJob> jobs, size_t threads)
+{
+	BatchResult result;
+	RunBatch(jobs, result, threads, false);
+	return result;
+}
+
+void Cipher::EncodeBatch(std::span<const BatchJob> jobs, BatchResult& out, size_t threads)
+{
+	RunBatch(jobs, out, threads, true);
+}
+
+void Cipher::DecodeBatch(std::span<const BatchJob> jobs, BatchResult& out, size_t threads)
+{
+	RunBatch(jobs, out, threads, false);
+}
+
+std::string Cipher::EncodeContainer(std::string_view text, std::string const& keyword)
+{
+	return Container::Encode(*Prepare(keyword), text);
+}
+
+std::string Cipher::DecodeContainer(std::string_view data, std::string const& keyword)
+{
+	ContainerHeader header = Container::ReadHeader(data);
+	auto key = Prepare(keyword, string_utils::utf8_to_u32(header.separator), header.schedule,
+		std::pmr::get_default_resource());
+	return Container::Decode(*key, data);
+}
+
+std::string Cipher::EncodeBinary(std::string_view text, std::string const& keyword)
+{
+	return BinaryFormat::Encode(*Prepare(keyword), text);
+}
+
+std::string Cipher::DecodeBinary(std::string_view data, std::string const& keyword)
+{
+	return BinaryFormat::Decode(*Prepare(keyword), data);
+}
+
+std::string Cipher::EncodeCompressed(std::string_view text, std::string const& keyword)
+{
+	return CompressedFormat::Encode(*Prepare(keyword), text);
+}
+
+std::string Cipher::DecodeCompressed(std::string_view data, std::string const& keyword)
+{
+	return CompressedFormat::Decode(*Prepare(keyword), data);
+}
+
+CompressedDecoder Cipher::CreateCompressedDecoder(std::string const& keyword, CompressedDecoder::Sink sink)
+{
+	return CompressedDecoder(Prepare(keyword), std::move(sink));
+}
+
+std::string Cipher::EncodeFixed(std::string_view text, std::string const& keyword)
+{
+	return Prepare(keyword, std::u32string_view(), m_schedule, std::pmr::get_default_resource())->Encode(text);
+}
+
+std::string Cipher::DecodeFixed(std::string_view data, std::string const& keyword)
+{
+	return Prepare(keyword, std::u32string_view(), m_schedule, std::pmr::get_default_resource())->DecodeFixed(data);
+}
+
+std::string Cipher::EncodeWrapped(std::string_view text, std::string const& keyword, size_t tokensPerLine)
+{
+	return Prepare(keyword, std::u32string_view(), m_schedule, std::pmr::get_default_resource())->EncodeWrapped(text, tokensPerLine);
+}
+
+std::string Cipher::DecodeWrapped(std::string_view data, std::string const& keyword)
+{
+	return Prepare(keyword, std::u32string_view(), m_schedule, std::pmr::get_default_resource())->DecodeWrapped(data);
+}
+
+SeekIndex Cipher::BuildIndex(std::string_view text, std::string const& keyword, size_t interval)
+{
+	return SeekIndex::Build(*Prepare(keyword), text, interval);
+}
+
+std::string Cipher::DecodeSlice(std::string_view ciphertext, std::string const& keyword, SeekIndex const& index,
+	uint64_t begin, uint64_t end)
+{
+	return index.DecodeSlice(*Prepare(keyword), ciphertext, begin, end);
+}
+
+std::string Cipher::EncodeSlice(std::string_view text, std::string const& keyword, SeekIndex const& index,
+	uint64_t begin, uint64_t end, uint64_t* offset)
+{
+	return index.EncodeSlice(*Prepare(keyword), text, begin, end, offset);
+}
+
+// MappedFile::Create truncates its file, which must not be the input still mapped for reading
+static void CheckDistinctFiles(std::filesystem::path const& input, std::filesystem::path const& output)
+{
+	std::error_code error;
+	if (std::filesystem::equivalent(input, output, error))
+		throw std::invalid_argument("Cipher: the output file is the input file");
+}
+
+// Maps output at size bytes, lets write fill it and cuts the file to what write returns.
+// If write throws, the partial output is closed (Windows cannot delete an open file) and removed.
+template <class Write>
+static size_t WriteMappedFile(std::filesystem::path const& output, size_t size, Write&& write)
+{
+	MappedFile target = MappedFile::Create(output, size);
+	try {
+		size_t written = write(target.Span());
+		target.Close(written);
+		return written;
+	}
+	catch (...) {
+		target.Close();
+		std::error_code error;
+		std::filesystem::remove(output, error);
+		throw;
+	}
+}
+
+size_t Cipher::EncodeFile(std::filesystem::path const& input, std::filesystem::path const& output, std::string const& keyword)
+{
+	CheckDistinctFiles(input, output);
+	auto key = Prepare(keyword);
+	MappedFile source = MappedFile::OpenRead(input);
+
+	// The exact size is known up front, so the output is mapped once at its final length and
+	// written without Encode measuring the input a second time
+	size_t size = key->EncodedSize(source.View());
+	return WriteMappedFile(output, size, [&](std::span<char> out) {
+		key->WriteEncoded(source.View(), out.data(), std::pmr::get_default_resource());
+		return size;
+	});
+}
+
+size_t Cipher::DecodeFile(std::filesystem::path const& input, std::filesystem::path const& output, std::string const& keyword)
+{
+	CheckDistinctFiles(input, output);
+	auto key = Prepare(keyword);
+	MappedFile source = MappedFile::OpenRead(input);
+
+	// Mapped at the bound and cut to the decoded size afterwards, saving a second pass over the input
+	return WriteMappedFile(output, key->DecodedSizeBound(source.View()), [&](std::span<char> out) {
+		return key->Decode(source.View(), out);
+	});
+}
+
+std::pmr::string Cipher::Encode(std::string_view text, std::string_view keyword, std::pmr::memory_resource* resource)
+{
+	return Prepare(keyword, resource)->Encode(text, resource);
+}
+
+std::pmr::string Cipher::Decode(std::string_view text, std::string_view keyword, std::pmr::memory_resource* resource)
+{
+	return Prepare(keyword, resource)->Decode(text, resource);
+}
+
+StreamEncoder Cipher::CreateEncoder(std::string const& keyword, StreamEncoder::Sink sink)
+{
+	return StreamEncoder(Prepare(keyword), std::move(sink));
+}
+
+StreamDecoder Cipher::CreateDecoder(std::string const& keyword, StreamDecoder::Sink sink)
+{
+	return StreamDecoder(Prepare(keyword), std::move(sink));
+}
+
+void Cipher::SetCacheBudget(size_t bytes)
+{
+	m_cache.SetBudget(bytes);
+}
+
+Cipher::CacheStats Cipher::GetCacheStats() const
+{
+	return m_cache.GetStats();
+}
+
+std::string Cipher::GetAlphabet() const
+{
+	return string_utils::u32_to_utf8(m_alphabet.Symbols());
+}
+
+void Cipher::SetAlphabet(std::string const& alphabet)
+{
+	m_alphabet = AlphabetIndex(string_utils::utf8_to_u32(alphabet));
+}
+
+
+std::string Cipher::GetSeparator() const
+{
+	return string_utils::u32_to_utf8(m_separator);
+}
+
+void Cipher::SetSeparator(std::string const& separator)
+{
+	m_separator = string_utils::utf8_to_u32(separator);
+}
+
+KeySchedule Cipher::GetKeySchedule() const
+{
+	return m_schedule;
+}
+
+void Cipher::SetKeySchedule(KeySchedule schedule)
+{
+	m_schedule = schedule;
+}
@@ -1,32 +1,144 @@
-#pragma once
-#include <string>
-#include <vector>
-
-class Cipher 
-{
-	struct Table {
-		std::vector<std::vector<char32_t>> table;
-		std::vector<std::u32string> rowKeys;
-		std::vector<std::u32string> colKeys;
-	};
-
-private:
-	std::u32string m_alphabet;
-	std::u32string m_separator;
-
-	Table BuildTable(std::u32string const& key);
-	std::u32string GetUniqueKey(std::u32string const& key);
-public:
-	Cipher(std::string const& alphabet, std::string const& separator = " ");
-
-	std::string Encode(std::string const& text, std::string const& keyword); 
-	std::string Decode(std::string const& text, std::string const& keyword);
-public:
-	std::string GetAlphabet() const;
-	void SetAlphabet(std::string const& alphabet);
-	__declspec(property(get = GetAlphabet, put = SetAlphabet)) std::string alphabet;
-
-	std::string GetSeparator() const;
-	void SetSeparator(std::string const& separator);
-	__declspec(property(get = GetSeparator, put = SetSeparator)) std::string separator;
+#pragma once
+#include "BinaryFormat.hpp"
+#include "CompressedDecoder.hpp"
+#include "CompressedFormat.hpp"
+#include "Container.hpp"
+#include "KeyCache.hpp"
+#include "PreparedKey.hpp"
+#include "SeekIndex.hpp"
+#include "StreamDecoder.hpp"
+#include "StreamEncoder.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Cipher 
+{
+	friend class PreparedKey;
+
+public:
+	using CacheStats = KeyCache<PreparedKey>::Stats;
+
+	static constexpr size_t DefaultCacheBudget = 16 << 20;
+
+	struct BatchJob {
+		std::string_view text;
+		std::string_view keyword;
+	};
+
+	// Results in job order, one after another: result i is data[offsets[i], offsets[i + 1])
+	struct BatchResult {
+		std::string data;
+		std::vector<size_t> offsets;
+
+		size_t Size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+		std::string_view operator[](size_t i) const {
+			return std::string_view(data).substr(offsets[i], offsets[i + 1] - offsets[i]);
+		}
+	};
+
+private:
+	// Input bytes a batch thread takes at a time
+	static constexpr size_t BatchUnitSize = 64 << 10;
+
+	AlphabetIndex m_alphabet;
+	std::u32string m_separator;
+	KeySchedule m_schedule;
+	KeyCache<PreparedKey> m_cache;
+
+	void RunBatch(std::span<const BatchJob> jobs, BatchResult& out, size_t threads, bool encode);
+	std::shared_ptr<const PreparedKey> Prepare(std::string_view keyword, std::u32string_view separator,
+		KeySchedule schedule, std::pmr::memory_resource* resource);
+public:
+	// Legacy is the default so that existing ciphertext keeps decoding; V1 gives the same
+	// tables on every platform, Positional also picks homophones that need no earlier text
+	Cipher(std::string const& alphabet, std::string const& separator = " ",
+		KeySchedule schedule = KeySchedule::Legacy);
+
+	// Only a cache miss allocates outside resource: prepared keys outlive any request and stay on the default heap
+	std::shared_ptr<const PreparedKey> Prepare(std::string_view keyword,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	std::string Encode(std::string_view text, std::string const& keyword); 
+	std::string Decode(std::string_view text, std::string const& keyword);
+	std::string EncodeParallel(std::string_view text, std::string const& keyword, size_t threads = 0);
+	std::string DecodeParallel(std::string_view text, std::string const& keyword, size_t threads = 0);
+
+	// Temporaries and the result come from resource, e.g. a monotonic arena released between requests
+	std::pmr::string Encode(std::string_view text, std::string_view keyword, std::pmr::memory_resource* resource);
+	std::pmr::string Decode(std::string_view text, std::string_view keyword, std::pmr::memory_resource* resource);
+
+	// Many short texts at once: every keyword is prepared once, and jobs sharing it are
+	// processed together on up to `threads` threads (0 = one per core). The overloads
+	// taking out reuse its buffers.
+	BatchResult EncodeBatch(std::span<const BatchJob> jobs, size_t threads = 0);
+	BatchResult DecodeBatch(std::span<const BatchJob> jobs, size_t threads = 0);
+	void EncodeBatch(std::span<const BatchJob> jobs, BatchResult& out, size_t threads = 0);
+	void DecodeBatch(std::span<const BatchJob> jobs, BatchResult& out, size_t threads = 0);
+
+	// Ciphertext behind a ContainerHeader. Decoding takes the separator and key schedule from
+	// the header, and checks alphabet, key and the plaintext CRC; see Container, also for keys
+	// whose containers never pass that check.
+	std::string EncodeContainer(std::string_view text, std::string const& keyword);
+	std::string DecodeContainer(std::string_view data, std::string const& keyword);
+
+	// Bit-packed ciphertext, see BinaryFormat
+	std::string EncodeBinary(std::string_view text, std::string const& keyword);
+	std::string DecodeBinary(std::string_view data, std::string const& keyword);
+
+	// Entropy-coded ciphertext, see CompressedFormat. The decoder takes it in chunks.
+	std::string EncodeCompressed(std::string_view text, std::string const& keyword);
+	std::string DecodeCompressed(std::string_view data, std::string const& keyword);
+	CompressedDecoder CreateCompressedDecoder(std::string const& keyword, CompressedDecoder::Sink sink);
+
+	// Fixed-width ciphertext: tokens back to back whatever the separator is, passthrough code
+	// points as they are. Every token is two alphabet symbols, so nothing needs escaping, and
+	// DecodeFixed decodes like Decode but keeps a trailing passthrough code point.
+	std::string EncodeFixed(std::string_view text, std::string const& keyword);
+	std::string DecodeFixed(std::string_view data, std::string const& keyword);
+
+	// Fixed-width ciphertext in lines of tokensPerLine tokens that decodes unchanged after any
+	// ASCII whitespace outside the alphabet was added or moved, e.g. by rewrapping; see
+	// PreparedKey::EncodeWrapped. The alphabet must not contain '\\'.
+	std::string EncodeWrapped(std::string_view text, std::string const& keyword, size_t tokensPerLine);
+	std::string DecodeWrapped(std::string_view data, std::string const& keyword);
+
+	// Random access through a sidecar index built from the plaintext, see SeekIndex
+	SeekIndex BuildIndex(std::string_view text, std::string const& keyword, size_t interval = SeekIndex::DefaultInterval);
+	std::string DecodeSlice(std::string_view ciphertext, std::string const& keyword, SeekIndex const& index,
+		uint64_t begin, uint64_t end);
+	std::string EncodeSlice(std::string_view text, std::string const& keyword, SeekIndex const& index,
+		uint64_t begin, uint64_t end, uint64_t* offset = nullptr);
+
+	// File to file through memory mappings, without reading either file into a string.
+	// Returns the bytes written to output; OS failures throw std::system_error, and an output
+	// that is the input file itself throws std::invalid_argument before anything is written.
+	size_t EncodeFile(std::filesystem::path const& input, std::filesystem::path const& output, std::string const& keyword);
+	size_t DecodeFile(std::filesystem::path const& input, std::filesystem::path const& output, std::string const& keyword);
+
+	StreamEncoder CreateEncoder(std::string const& keyword, StreamEncoder::Sink sink);
+	StreamDecoder CreateDecoder(std::string const& keyword, StreamDecoder::Sink sink);
+
+	void SetCacheBudget(size_t bytes);
+	CacheStats GetCacheStats() const;
+public:
+	std::string GetAlphabet() const;
+	void SetAlphabet(std::string const& alphabet);
+#ifdef _MSC_VER
+	__declspec(property(get = GetAlphabet, put = SetAlphabet)) std::string alphabet;
+#endif
+
+	std::string GetSeparator() const;
+	void SetSeparator(std::string const& separator);
+#ifdef _MSC_VER
+	__declspec(property(get = GetSeparator, put = SetSeparator)) std::string separator;
+#endif
+
+	KeySchedule GetKeySchedule() const;
+	void SetKeySchedule(KeySchedule schedule);
 };
\ No newline at end of file
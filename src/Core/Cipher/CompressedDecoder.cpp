@@ -0,0 +1,42 @@
+#include "CompressedDecoder.hpp"
+
+#include <stdexcept>
+
+CompressedDecoder::CompressedDecoder(std::shared_ptr<const PreparedKey> key, Sink sink)
+	: m_key(std::move(key)), m_sink(std::move(sink))
+{
+}
+
+void CompressedDecoder::Write(std::string_view chunk)
+{
+	// Whole blocks are decoded straight from the chunk; only a cut-off one is copied
+	bool buffered = !m_input.empty();
+	if (buffered)
+		m_input.append(chunk);
+	std::string_view data = buffered ? std::string_view(m_input) : chunk;
+
+	size_t used = 0;
+	while (size_t size = CompressedFormat::BlockSize(*m_key, data.substr(used))) {
+		if (size > data.size() - used)
+			break;
+
+		CompressedFormat::DecodeBlock(*m_key, data.substr(used, size), m_buffer);
+		used += size;
+		if (!m_buffer.empty())
+			m_sink(m_buffer);
+		m_buffer.clear();
+	}
+
+	if (buffered)
+		m_input.erase(0, used);
+	else
+		m_input.assign(data.substr(used));
+}
+
+void CompressedDecoder::Finish()
+{
+	if (!m_input.empty()) {
+		m_input.clear();
+		throw std::invalid_argument("CompressedFormat: truncated data");
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "CompressedFormat.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Decodes CompressedFormat data that arrives in arbitrary byte chunks and hands the plaintext
+// of every block to a sink as soon as the block is complete, so memory stays at about one block.
+class CompressedDecoder
+{
+public:
+	using Sink = std::function<void(std::string_view)>;
+
+private:
+	std::shared_ptr<const PreparedKey> m_key;
+	Sink m_sink;
+
+	std::string m_input;		// start of a block cut off by the previous chunk
+	std::string m_buffer;
+public:
+	CompressedDecoder(std::shared_ptr<const PreparedKey> key, Sink sink);
+
+	// Throws std::invalid_argument on malformed input; plaintext of earlier blocks may already be in the sink
+	void Write(std::string_view chunk);
+	// Throws std::invalid_argument if the input ended inside a block
+	void Finish();
+};
@@ -0,0 +1,412 @@
+#include "CompressedFormat.hpp"
+#include "BinaryFormat.hpp"
+#include "BitStream.hpp"
+#include "../../Utils/StringUtils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// Codes of a block before they are assigned symbols: homophone index, or the flag and a passthrough code point
+	constexpr uint32_t PassthroughFlag = 0x80000000;
+	// Codes up to this length are decoded with one table lookup
+	constexpr unsigned TableBits = 11;
+
+	uint32_t ReadLE(const char* p, size_t bytes)
+	{
+		uint32_t value = 0;
+		for (size_t i = 0; i < bytes; ++i)
+			value |= static_cast<uint32_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+		return value;
+	}
+
+	void AppendLE(std::string& out, uint32_t value, size_t bytes)
+	{
+		for (size_t i = 0; i < bytes; ++i)
+			out += static_cast<char>(value >> (8 * i));
+	}
+
+	// Huffman code lengths for freqs, unused symbols get 0. Codes longer than MaxCodeBits are
+	// avoided by halving the frequencies until the tree is shallow enough.
+	std::vector<uint8_t> BuildCodeLengths(std::vector<uint32_t> freqs)
+	{
+		std::vector<uint8_t> lengths(freqs.size(), 0);
+		std::vector<uint32_t> used;
+		for (uint32_t s = 0; s < freqs.size(); ++s)
+			if (freqs[s]) used.push_back(s);
+
+		if (used.size() == 1)
+			lengths[used[0]] = 1;
+		if (used.size() <= 1)
+			return lengths;
+
+		size_t leaves = used.size();
+		std::vector<uint64_t> weight(2 * leaves - 1);
+		std::vector<uint32_t> parent(2 * leaves - 1);
+		std::vector<uint32_t> depth(2 * leaves - 1);
+		for (;;) {
+			std::sort(used.begin(), used.end(), [&](uint32_t a, uint32_t b) {
+				return freqs[a] != freqs[b] ? freqs[a] < freqs[b] : a < b;
+			});
+			for (size_t i = 0; i < leaves; ++i)
+				weight[i] = freqs[used[i]];
+
+			// Two queues: sorted leaves, and inner nodes, which are created in order of weight
+			size_t leaf = 0, inner = leaves;
+			auto take = [&](size_t next) {
+				return leaf < leaves && (inner == next || weight[leaf] <= weight[inner]) ? leaf++ : inner++;
+			};
+			for (size_t next = leaves; next < weight.size(); ++next) {
+				size_t a = take(next);
+				size_t b = take(next);
+				weight[next] = weight[a] + weight[b];
+				parent[a] = parent[b] = static_cast<uint32_t>(next);
+			}
+
+			// Parents come after their children, so depths fill in from the root down
+			depth.back() = 0;
+			uint32_t deepest = 0;
+			for (size_t i = weight.size() - 1; i-- > 0;) {
+				depth[i] = depth[parent[i]] + 1;
+				if (i < leaves) deepest = std::max(deepest, depth[i]);
+			}
+
+			if (deepest <= CompressedFormat::MaxCodeBits) {
+				for (size_t i = 0; i < leaves; ++i)
+					lengths[used[i]] = static_cast<uint8_t>(depth[i]);
+				return lengths;
+			}
+			for (auto s : used)
+				freqs[s] = (freqs[s] >> 1) | 1;
+		}
+	}
+
+	uint32_t ReverseBits(uint32_t code, unsigned bits)
+	{
+		uint32_t reversed = 0;
+		for (unsigned i = 0; i < bits; ++i, code >>= 1)
+			reversed = (reversed << 1) | (code & 1);
+		return reversed;
+	}
+
+	// Canonical code of every symbol, bit-reversed for the least significant bit first stream
+	std::vector<uint32_t> BuildCodes(std::vector<uint8_t> const& lengths)
+	{
+		uint32_t counts[CompressedFormat::MaxCodeBits + 1] = {};
+		for (auto length : lengths)
+			counts[length]++;
+		counts[0] = 0;
+
+		uint32_t next[CompressedFormat::MaxCodeBits + 1] = {};
+		uint32_t code = 0;
+		for (unsigned bits = 1; bits <= CompressedFormat::MaxCodeBits; ++bits) {
+			code = (code + counts[bits - 1]) << 1;
+			next[bits] = code;
+		}
+
+		std::vector<uint32_t> codes(lengths.size(), 0);
+		for (size_t s = 0; s < lengths.size(); ++s)
+			if (lengths[s])
+				codes[s] = ReverseBits(next[lengths[s]]++, lengths[s]);
+		return codes;
+	}
+
+	// Canonical Huffman decoder: one lookup for codes up to TableBits, a walk over the code
+	// lengths for longer ones
+	class HuffmanDecoder
+	{
+		struct Entry {
+			uint16_t symbol;
+			uint8_t length;		// 0 = longer than TableBits, or no code
+		};
+
+		std::vector<Entry> m_table;
+		uint32_t m_counts[CompressedFormat::MaxCodeBits + 1] = {};
+		std::vector<uint16_t> m_sorted;		// symbols by code length, then value
+
+		std::pair<uint32_t, unsigned> DecodeLong(uint64_t bits) const {
+			uint32_t code = 0, first = 0, index = 0;
+			for (unsigned length = 1; length <= CompressedFormat::MaxCodeBits; ++length) {
+				code |= static_cast<uint32_t>(bits >> (length - 1)) & 1;
+				uint32_t count = m_counts[length];
+				if (code - first < count)
+					return { m_sorted[index + code - first], length };
+				index += count;
+				first = (first + count) << 1;
+				code <<= 1;
+			}
+			throw std::invalid_argument("CompressedFormat: invalid code");
+		}
+	public:
+		explicit HuffmanDecoder(std::vector<uint8_t> const& lengths) : m_table(size_t(1) << TableBits, Entry{ 0, 0 }) {
+			for (auto length : lengths)
+				m_counts[length]++;
+			m_counts[0] = 0;
+
+			// Over-subscribed lengths would make codes ambiguous
+			int64_t left = 1;
+			for (unsigned bits = 1; bits <= CompressedFormat::MaxCodeBits; ++bits) {
+				left = (left << 1) - m_counts[bits];
+				if (left < 0)
+					throw std::invalid_argument("CompressedFormat: invalid code lengths");
+			}
+
+			for (unsigned bits = 1; bits <= CompressedFormat::MaxCodeBits; ++bits)
+				for (size_t s = 0; s < lengths.size(); ++s)
+					if (lengths[s] == bits) m_sorted.push_back(static_cast<uint16_t>(s));
+
+			std::vector<uint32_t> codes = BuildCodes(lengths);
+			for (size_t s = 0; s < lengths.size(); ++s) {
+				if (lengths[s] == 0 || lengths[s] > TableBits)
+					continue;
+				for (uint32_t fill = codes[s]; fill < m_table.size(); fill += 1u << lengths[s])
+					m_table[fill] = { static_cast<uint16_t>(s), lengths[s] };
+			}
+		}
+
+		// Symbol and code length of the code at the low bits of bits
+		std::pair<uint32_t, unsigned> Decode(uint64_t bits) const {
+			Entry entry = m_table[bits & ((1u << TableBits) - 1)];
+			if (entry.length)
+				return { entry.symbol, entry.length };
+			return DecodeLong(bits);
+		}
+	};
+
+	struct BlockHeader {
+		uint32_t codes;
+		uint32_t payload;
+		std::vector<char32_t> literals;
+		std::vector<uint8_t> lengths;
+		size_t size;		// bytes up to the payload
+	};
+
+	size_t LengthBytes(size_t symbols) { return (symbols + 1) / 2; }
+
+	// Value per passthrough code point, looked up directly below AlphabetIndex::DirectRange;
+	// 0 = not present
+	class PassthroughMap
+	{
+		std::vector<uint32_t> m_direct = std::vector<uint32_t>(AlphabetIndex::DirectRange, 0);
+		std::unordered_map<char32_t, uint32_t> m_other;
+	public:
+		uint32_t& operator[](char32_t c) { return c < AlphabetIndex::DirectRange ? m_direct[c] : m_other[c]; }
+
+		template <class Visit>
+		void ForEach(Visit&& visit) {
+			for (char32_t c = 0; c < AlphabetIndex::DirectRange; ++c)
+				if (m_direct[c]) visit(c, m_direct[c]);
+			for (auto& [c, value] : m_other)
+				visit(c, value);
+		}
+	};
+
+	// Appends a block for codes; tokens is the key's homophone count
+	void WriteBlock(std::vector<uint32_t> const& codes, uint32_t tokens, std::string& out)
+	{
+		// The most frequent passthrough code points used more than once become literals
+		PassthroughMap passthrough;
+		for (auto code : codes)
+			if (code & PassthroughFlag) passthrough[code & ~PassthroughFlag]++;
+		std::vector<std::pair<uint32_t, char32_t>> runs;
+		passthrough.ForEach([&](char32_t c, uint32_t count) {
+			if (count > 1) runs.emplace_back(count, c);
+		});
+		size_t literalCount = std::min(runs.size(), CompressedFormat::MaxLiterals);
+		std::partial_sort(runs.begin(), runs.begin() + literalCount, runs.end(), std::greater<>());
+		std::vector<char32_t> literals;
+		for (size_t i = 0; i < literalCount; ++i)
+			literals.push_back(runs[i].second);
+		std::sort(literals.begin(), literals.end());
+
+		// From here on the map holds the symbol of every passthrough code point instead of its count
+		uint32_t escape = tokens + static_cast<uint32_t>(literals.size());
+		passthrough.ForEach([&](char32_t, uint32_t& symbol) { symbol = escape; });
+		for (size_t i = 0; i < literals.size(); ++i)
+			passthrough[literals[i]] = tokens + static_cast<uint32_t>(i);
+		auto symbolOf = [&](uint32_t code) {
+			return code & PassthroughFlag ? passthrough[code & ~PassthroughFlag] : code;
+		};
+
+		std::vector<uint32_t> freqs(escape + 1, 0);
+		for (auto code : codes)
+			freqs[symbolOf(code)]++;
+		std::vector<uint8_t> lengths = BuildCodeLengths(std::move(freqs));
+		std::vector<uint32_t> huffman = BuildCodes(lengths);
+
+		size_t start = out.size();
+		AppendLE(out, static_cast<uint32_t>(codes.size()), 4);
+		AppendLE(out, 0, 4);
+		out += static_cast<char>(literals.size());
+		for (auto c : literals)
+			AppendLE(out, c, 3);
+		for (size_t s = 0; s < lengths.size(); s += 2)
+			out += static_cast<char>(lengths[s] | (s + 1 < lengths.size() ? lengths[s + 1] << 4 : 0));
+
+		size_t payload = out.size();
+		BitWriter writer(out);
+		for (auto code : codes) {
+			uint32_t symbol = symbolOf(code);
+			writer.Put(huffman[symbol], lengths[symbol]);
+			if (symbol == escape)
+				writer.Put(code & ~PassthroughFlag, BinaryFormat::CodePointBits);
+		}
+		writer.Flush();
+
+		uint32_t bytes = static_cast<uint32_t>(out.size() - payload);
+		for (size_t i = 0; i < 4; ++i)
+			out[start + 4 + i] = static_cast<char>(bytes >> (8 * i));
+	}
+
+	// Bytes of the header of the block at data, of which the fixed part is checked;
+	// tokens is the key's homophone count
+	size_t HeaderBytes(std::string_view data, size_t tokens)
+	{
+		uint32_t codes = ReadLE(data.data(), 4);
+		uint32_t payload = ReadLE(data.data() + 4, 4);
+		size_t literals = static_cast<unsigned char>(data[8]);
+		// Every code takes at most MaxCodeBits and a code point
+		uint64_t maxPayload = (static_cast<uint64_t>(codes) * (CompressedFormat::MaxCodeBits + BinaryFormat::CodePointBits) + 7) / 8;
+		if (codes == 0 || codes > CompressedFormat::BlockCodes || literals > CompressedFormat::MaxLiterals || payload > maxPayload)
+			throw std::invalid_argument("CompressedFormat: invalid block header");
+		return CompressedFormat::FixedHeaderSize + 3 * literals + LengthBytes(tokens + literals + 1);
+	}
+
+	// Returns false while the header is incomplete
+	bool ReadBlockHeader(std::string_view data, size_t tokens, BlockHeader& header)
+	{
+		if (data.size() < CompressedFormat::FixedHeaderSize)
+			return false;
+		header.size = HeaderBytes(data, tokens);
+		if (data.size() < header.size)
+			return false;
+
+		header.codes = ReadLE(data.data(), 4);
+		header.payload = ReadLE(data.data() + 4, 4);
+		const char* p = data.data() + CompressedFormat::FixedHeaderSize;
+		header.literals.resize(static_cast<unsigned char>(data[8]));
+		for (auto& literal : header.literals) {
+			literal = ReadLE(p, 3);
+			p += 3;
+			if (literal > 0x10FFFF || (literal >= 0xD800 && literal <= 0xDFFF))
+				throw std::invalid_argument("CompressedFormat: invalid code point");
+		}
+		header.lengths.resize(tokens + header.literals.size() + 1);
+		for (size_t s = 0; s < header.lengths.size(); ++s)
+			header.lengths[s] = (static_cast<unsigned char>(p[s / 2]) >> (s % 2 * 4)) & 0xF;
+		return true;
+	}
+}
+
+size_t CompressedFormat::BlockSize(PreparedKey const& key, std::string_view data)
+{
+	if (data.size() < FixedHeaderSize)
+		return 0;
+	return HeaderBytes(data, key.m_table.tokens.size()) + ReadLE(data.data() + 4, 4);
+}
+
+void CompressedFormat::DecodeBlock(PreparedKey const& key, std::string_view block, std::string& out)
+{
+	BlockHeader header;
+	if (!ReadBlockHeader(block, key.m_table.tokens.size(), header) || block.size() < header.size + header.payload)
+		throw std::invalid_argument("CompressedFormat: truncated data");
+
+	auto const& symbols = key.m_table.tokenSymbols;
+	uint32_t tokens = static_cast<uint32_t>(symbols.size());
+	uint32_t escape = tokens + static_cast<uint32_t>(header.literals.size());
+	HuffmanDecoder decoder(header.lengths);
+
+	// Every code yields at most one code point
+	size_t offset = out.size();
+	out.resize(offset + header.codes * 4);
+	char* it = out.data() + offset;
+
+	BitReader reader(block.data() + header.size, header.payload);
+	constexpr unsigned WordBits = 57;
+	constexpr unsigned LongestCode = MaxCodeBits + BinaryFormat::CodePointBits;
+	uint32_t remaining = header.codes;
+	while (remaining) {
+		uint64_t word = reader.Peek();
+		unsigned used = 0;
+		while (remaining && used + LongestCode <= WordBits) {
+			auto [symbol, length] = decoder.Decode(word >> used);
+			used += length;
+			if (symbol < tokens) {
+				if (symbols[symbol] != PreparedKey::NoSymbol)
+					it = string_utils::write_utf8(it, symbols[symbol]);
+			}
+			else if (symbol < escape) {
+				it = string_utils::write_utf8(it, header.literals[symbol - tokens]);
+			}
+			else {
+				char32_t c = static_cast<char32_t>(word >> used) & ((1u << BinaryFormat::CodePointBits) - 1);
+				if (c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+					throw std::invalid_argument("CompressedFormat: invalid code point");
+				it = string_utils::write_utf8(it, c);
+				used += BinaryFormat::CodePointBits;
+			}
+			--remaining;
+		}
+
+		if (used > reader.Remaining())
+			throw std::invalid_argument("CompressedFormat: truncated data");
+		reader.Skip(used);
+	}
+
+	out.resize(it - out.data());
+}
+
+std::string CompressedFormat::Encode(PreparedKey const& key, std::string_view text)
+{
+	auto const& table = key.m_table;
+	// Codes of at most MaxCodeBits exist for every block only up to this many symbols
+	if (table.tokens.size() + MaxLiterals + 1 > size_t(1) << MaxCodeBits)
+		throw std::invalid_argument("CompressedFormat: alphabet too large");
+	std::vector<size_t> counters(key.m_alphabet.Size(), 0);
+	std::vector<uint32_t> codes;
+	codes.reserve(BlockCodes);
+
+	std::string result;
+	result.reserve(text.size() / 2);
+	const char* it = text.data();
+	const char* end = it + text.size();
+	while (it != end) {
+		const char* start = it;
+		char32_t c = string_utils::next_code_point(it, end);
+		uint32_t pos = key.m_alphabet.Find(c);
+		if (pos == AlphabetIndex::NotFound) {
+			codes.push_back(PassthroughFlag | c);
+		}
+		else {
+			// The homophone Encode would pick
+			codes.push_back(static_cast<uint32_t>(key.PickToken(pos, counters.data(), start - text.data())));
+		}
+
+		if (codes.size() == BlockCodes) {
+			WriteBlock(codes, static_cast<uint32_t>(table.tokens.size()), result);
+			codes.clear();
+		}
+	}
+
+	if (!codes.empty())
+		WriteBlock(codes, static_cast<uint32_t>(table.tokens.size()), result);
+	return result;
+}
+
+std::string CompressedFormat::Decode(PreparedKey const& key, std::string_view data)
+{
+	std::string result;
+	result.reserve(data.size() * 2);
+	while (!data.empty()) {
+		size_t size = BlockSize(key, data);
+		if (size == 0 || size > data.size())
+			throw std::invalid_argument("CompressedFormat: truncated data");
+		DecodeBlock(key, data.substr(0, size), result);
+		data.remove_prefix(size);
+	}
+	return result;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "PreparedKey.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Entropy-coded form of a ciphertext. The codes are those of BinaryFormat (homophone indices
+// of the key and passthrough code points), cut into blocks of up to BlockCodes codes, and every
+// block is written with its own canonical Huffman code. The most frequent passthrough code
+// points of a block get codes of their own, the rest follow an escape code in 21 bits.
+// Block layout, integers little-endian:
+//   0  u32 codes n
+//   4  u32 bytes of the block after the header
+//   8  u8  literal code points L
+//   9  L x u24 literal code points
+//      code lengths of tokens, literals and the escape, 4 bits each, low nibble first
+//      Huffman codes of the n codes, least significant bit first, padded to a byte
+// The form depends on the key's token list like BinaryFormat, so it keeps the homophone
+// distribution of the ciphertext and is not a compressed plaintext.
+class CompressedFormat
+{
+public:
+	static constexpr size_t BlockCodes = 1 << 16;
+	static constexpr size_t FixedHeaderSize = 9;
+	static constexpr size_t MaxLiterals = 64;
+	static constexpr unsigned MaxCodeBits = 15;
+
+	static std::string Encode(PreparedKey const& key, std::string_view text);
+	// Same plaintext as PreparedKey::Decode of the text ciphertext, except that a trailing
+	// passthrough code point is kept. So Decode(Encode(text)) == text only where the key's decode
+	// table maps every token back to its symbol, which fails for small alphabets whose row or
+	// column keys repeat symbols. Throws std::invalid_argument on malformed data.
+	static std::string Decode(PreparedKey const& key, std::string_view data);
+
+	// Bytes of the block at the front of data, or 0 while its header is incomplete
+	static size_t BlockSize(PreparedKey const& key, std::string_view data);
+	// Appends the plaintext of the block of BlockSize(key, block) bytes at the front of block to out
+	static void DecodeBlock(PreparedKey const& key, std::string_view block, std::string& out);
+};
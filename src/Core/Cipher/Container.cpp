@@ -0,0 +1,125 @@
+#include "Container.hpp"
+#include "../../Utils/Crc32c.hpp"
+#include "../../Utils/StringUtils.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+static const char Magic[4] = { 'S', 'U', 'B', 'C' };
+
+static void PutLittle(char* out, uint64_t value, size_t bytes)
+{
+	for (size_t i = 0; i < bytes; ++i)
+		out[i] = static_cast<char>(value >> (8 * i));
+}
+
+static uint64_t GetLittle(const char* in, size_t bytes)
+{
+	uint64_t value = 0;
+	for (size_t i = 0; i < bytes; ++i)
+		value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+	return value;
+}
+
+bool Container::IsContainer(std::string_view data)
+{
+	return data.size() >= FixedHeaderSize && std::memcmp(data.data(), Magic, sizeof(Magic)) == 0;
+}
+
+ContainerHeader Container::ReadHeader(std::string_view data)
+{
+	if (!IsContainer(data))
+		throw std::invalid_argument("Container: not a container");
+
+	const char* p = data.data();
+	ContainerHeader header;
+	header.version = static_cast<uint8_t>(p[4]);
+	if (header.version != Version)
+		throw std::invalid_argument("Container: unsupported version " + std::to_string(header.version));
+
+	uint8_t schedule = static_cast<uint8_t>(p[5]);
+	if (schedule > static_cast<uint8_t>(KeySchedule::Positional))
+		throw std::invalid_argument("Container: unknown key schedule");
+	header.schedule = static_cast<KeySchedule>(schedule);
+
+	size_t separatorBytes = GetLittle(p + 6, 2);
+	header.alphabetHash = GetLittle(p + 8, 8);
+	header.keyFingerprint = static_cast<uint32_t>(GetLittle(p + 16, 4));
+	header.plaintextCrc = static_cast<uint32_t>(GetLittle(p + 20, 4));
+	header.plaintextLength = GetLittle(p + 24, 8);
+	header.ciphertextLength = GetLittle(p + 32, 8);
+
+	if (data.size() - FixedHeaderSize < separatorBytes)
+		throw std::invalid_argument("Container: truncated header");
+	header.separator.assign(p + FixedHeaderSize, separatorBytes);
+	return header;
+}
+
+std::string Container::Encode(PreparedKey const& key, std::string_view text)
+{
+	std::string separator = string_utils::u32_to_utf8(key.m_separator);
+	if (separator.size() > UINT16_MAX)
+		throw std::invalid_argument("Container: separator is too long");
+
+	size_t headerSize = FixedHeaderSize + separator.size();
+	size_t encodedSize = key.EncodedSize(text);
+
+	std::string result(headerSize + encodedSize, '\0');
+	char* p = result.data();
+	std::memcpy(p, Magic, sizeof(Magic));
+	p[4] = static_cast<char>(Version);
+	p[5] = static_cast<char>(key.m_schedule);
+	PutLittle(p + 6, separator.size(), 2);
+	PutLittle(p + 8, string_utils::str_hash(key.m_alphabet.Symbols()), 8);
+	PutLittle(p + 16, key.m_fingerprint, 4);
+	PutLittle(p + 20, crc32c::compute(text), 4);
+	PutLittle(p + 24, text.size(), 8);
+	PutLittle(p + 32, encodedSize, 8);
+	std::memcpy(p + FixedHeaderSize, separator.data(), separator.size());
+
+	key.WriteEncoded(text, p + headerSize, std::pmr::get_default_resource());
+	return result;
+}
+
+std::string Container::Decode(PreparedKey const& key, std::string_view data)
+{
+	ContainerHeader header = ReadHeader(data);
+	if (header.alphabetHash != string_utils::str_hash(key.m_alphabet.Symbols()))
+		throw std::invalid_argument("Container: written with a different alphabet");
+	if (header.separator != string_utils::u32_to_utf8(key.m_separator) || header.schedule != key.m_schedule)
+		throw std::invalid_argument("Container: written with a different separator or key schedule");
+	if (header.keyFingerprint != key.m_fingerprint)
+		throw std::invalid_argument("Container: wrong key");
+
+	std::string_view ciphertext = data.substr(FixedHeaderSize + header.separator.size());
+	if (ciphertext.size() != header.ciphertextLength)
+		throw std::runtime_error("Container: ciphertext length does not match the header");
+
+	// Checked before allocating, so a forged length cannot ask for more than the ciphertext can hold
+	if (header.plaintextLength > key.DecodedSizeBound(ciphertext) + 4)
+		throw std::runtime_error("Container: plaintext length exceeds what the ciphertext can decode to");
+
+	std::string result(header.plaintextLength, '\0');
+	uint32_t crc = 0;
+	size_t decoded;
+	try {
+		decoded = key.Decode(ciphertext, std::span<char>(result), [&](std::string_view block) {
+			crc = crc32c::update(crc, block.data(), block.size());
+		});
+	}
+	catch (std::length_error const&) {
+		throw std::runtime_error("Container: ciphertext decodes to more than the header says");
+	}
+
+	// Decode never emits the last code point of its input, so a plaintext ending outside the
+	// alphabet loses that code point; it is the last one of the ciphertext as well
+	size_t missing = result.size() - decoded;
+	if (missing > 4 || missing > ciphertext.size())
+		throw std::runtime_error("Container: ciphertext decodes to less than the header says");
+	std::memcpy(result.data() + decoded, ciphertext.data() + ciphertext.size() - missing, missing);
+	crc = crc32c::update(crc, result.data() + decoded, missing);
+
+	if (crc != header.plaintextCrc)
+		throw std::runtime_error("Container: plaintext checksum mismatch");
+	return result;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "PreparedKey.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Fields of the header in front of a ciphertext in container form
+struct ContainerHeader {
+	uint8_t version = 0;
+	KeySchedule schedule = KeySchedule::Legacy;
+	uint64_t alphabetHash = 0;		// string_utils::str_hash of the alphabet code points
+	std::string separator;			// UTF-8
+	uint32_t keyFingerprint = 0;	// PreparedKey::GetFingerprint
+	uint32_t plaintextCrc = 0;		// CRC-32C
+	uint64_t plaintextLength = 0;
+	uint64_t ciphertextLength = 0;
+};
+
+// Ciphertext with a header that says how to decode it and how to check the result.
+// Layout, integers little-endian:
+//   0  "SUBC"
+//   4  u8  version (1)
+//   5  u8  key schedule
+//   6  u16 separator bytes n
+//   8  u64 alphabet hash
+//  16  u32 key fingerprint
+//  20  u32 CRC-32C of the plaintext
+//  24  u64 plaintext bytes
+//  32  u64 ciphertext bytes
+//  40  separator, n bytes
+//  40 + n  ciphertext
+// The fingerprint lets a wrong key be rejected without decoding; like any such check it also
+// lets guessed keywords be tested offline.
+class Container
+{
+public:
+	static constexpr uint8_t Version = 1;
+	static constexpr size_t FixedHeaderSize = 40;
+
+	static bool IsContainer(std::string_view data);
+	// Throws std::invalid_argument if data does not start with a well-formed header
+	static ContainerHeader ReadHeader(std::string_view data);
+
+	static std::string Encode(PreparedKey const& key, std::string_view text);
+	// Throws std::invalid_argument if key is not the one the container was written with, and
+	// std::runtime_error if the ciphertext is damaged. The result is checked against the CRC
+	// while it is decoded, into a buffer allocated once at the plaintext length.
+	// The CRC is of the text given to Encode, so a key whose decode table does not map every
+	// token back to its symbol (small alphabets whose row or column keys repeat symbols) writes
+	// containers whose plaintext does not decode back, and Decode rejects them as damaged.
+	static std::string Decode(PreparedKey const& key, std::string_view data);
+};
@@ -0,0 +1,149 @@
+#pragma once
+#include "../../Utils/StringUtils.hpp"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Memory-bounded LRU cache of prepared key tables.
+// Value must provide size_t MemoryUsage() const.
+template <class Value>
+class KeyCache
+{
+public:
+	struct Key {
+		std::u32string alphabet;
+		std::u32string separator;
+		std::u32string keyword;
+		uint32_t schedule = 0;
+
+		bool operator==(Key const&) const = default;
+	};
+
+	// Looks a key up without copying it
+	struct KeyView {
+		std::u32string_view alphabet;
+		std::u32string_view separator;
+		std::u32string_view keyword;
+		uint32_t schedule = 0;
+
+		KeyView(std::u32string_view alphabet, std::u32string_view separator, std::u32string_view keyword,
+			uint32_t schedule = 0)
+			: alphabet(alphabet), separator(separator), keyword(keyword), schedule(schedule) {}
+		KeyView(Key const& key)
+			: alphabet(key.alphabet), separator(key.separator), keyword(key.keyword), schedule(key.schedule) {}
+
+		bool operator==(KeyView const&) const = default;
+	};
+
+	struct Stats {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t evictions = 0;
+		size_t entries = 0;
+		size_t bytes = 0;
+		size_t budget = 0;
+	};
+
+private:
+	struct KeyHash {
+		using is_transparent = void;
+
+		size_t operator()(KeyView key) const {
+			uint64_t hash = string_utils::str_hash(key.alphabet);
+			hash = hash * 31 + string_utils::str_hash(key.separator);
+			hash = hash * 31 + string_utils::str_hash(key.keyword);
+			hash = hash * 31 + key.schedule;
+			return static_cast<size_t>(hash);
+		}
+	};
+
+	struct KeyEqual {
+		using is_transparent = void;
+
+		bool operator()(KeyView a, KeyView b) const { return a == b; }
+	};
+
+	struct Entry {
+		Key key;
+		std::shared_ptr<const Value> value;
+		size_t bytes;
+	};
+
+	using entries_t = std::list<Entry>;
+	using index_t = std::unordered_map<Key, typename entries_t::iterator, KeyHash, KeyEqual>;
+
+	mutable std::mutex	m_mutex;
+	entries_t			m_entries;		// most recently used first
+	index_t				m_index;
+	Stats				m_stats;
+
+	static size_t EntrySize(KeyView key, Value const& value) {
+		return sizeof(Entry) + value.MemoryUsage() +
+			(key.alphabet.size() + key.separator.size() + key.keyword.size()) * sizeof(char32_t);
+	}
+
+	void Trim() {
+		while (m_stats.bytes > m_stats.budget && !m_entries.empty()) {
+			auto& last = m_entries.back();
+			m_stats.bytes -= last.bytes;
+			m_index.erase(last.key);
+			m_entries.pop_back();
+			m_stats.evictions++;
+		}
+		m_stats.entries = m_entries.size();
+	}
+
+public:
+	explicit KeyCache(size_t budget) { m_stats.budget = budget; }
+
+	template <class Build>
+	std::shared_ptr<const Value> GetOrBuild(KeyView key, Build&& build) {
+		{
+			std::lock_guard lock(m_mutex);
+			auto it = m_index.find(key);
+			if (it != m_index.end()) {
+				m_entries.splice(m_entries.begin(), m_entries, it->second);
+				m_stats.hits++;
+				return it->second->value;
+			}
+			m_stats.misses++;
+		}
+
+		std::shared_ptr<const Value> value = build();
+		size_t bytes = EntrySize(key, *value);
+
+		std::lock_guard lock(m_mutex);
+		if (bytes > m_stats.budget || m_index.contains(key))
+			return value;
+
+		m_entries.push_front({ Key{ std::u32string(key.alphabet), std::u32string(key.separator), std::u32string(key.keyword), key.schedule },
+			value, bytes });
+		m_index.emplace(m_entries.front().key, m_entries.begin());
+		m_stats.bytes += bytes;
+		Trim();
+		return value;
+	}
+
+	void SetBudget(size_t budget) {
+		std::lock_guard lock(m_mutex);
+		m_stats.budget = budget;
+		Trim();
+	}
+
+	void Clear() {
+		std::lock_guard lock(m_mutex);
+		m_entries.clear();
+		m_index.clear();
+		m_stats.bytes = 0;
+		m_stats.entries = 0;
+	}
+
+	Stats GetStats() const {
+		std::lock_guard lock(m_mutex);
+		return m_stats;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <variant>
+
+// How a keyword's seeds are turned into the shuffles of the key table and the homophone order.
+// The schedule is part of the key: text encoded under one only decodes under the same one.
+enum class KeySchedule : uint8_t {
+	// std::mt19937_64 and std::shuffle. Output of std::shuffle is implementation-defined, so
+	// ciphertext is only guaranteed to decode with the standard library that produced it.
+	Legacy = 0,
+	// SplitMix64 and the Fisher-Yates shuffle below, identical on every platform
+	V1 = 1,
+	// V1 tables, but the homophone of each plaintext symbol is a keyed hash of the symbol and its
+	// byte offset in the plaintext instead of the next one in the symbol's cycle. Any part of a
+	// text then encodes on its own, and an edit that keeps lengths changes only its own tokens.
+	Positional = 2,
+};
+
+// SplitMix64 (Steele, Lea, Flood 2014): state += 0x9E3779B97F4A7C15, then the output mix
+class SplitMix64
+{
+	uint64_t m_state;
+public:
+	explicit SplitMix64(uint64_t seed) : m_state(seed) {}
+
+	static uint64_t Mix(uint64_t z) {
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	uint64_t Next() {
+		return Mix(m_state += 0x9E3779B97F4A7C15ull);
+	}
+
+	// Uniform in [0, bound) for 0 < bound <= 2^32: Lemire's multiply-shift on the upper 32 bits
+	// of Next(), drawing again while the low half of the product is below 2^32 mod bound
+	uint32_t Below(uint32_t bound) {
+		uint64_t product = (Next() >> 32) * bound;
+		if (static_cast<uint32_t>(product) < bound) {
+			uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+			while (static_cast<uint32_t>(product) < threshold)
+				product = (Next() >> 32) * bound;
+		}
+		return static_cast<uint32_t>(product >> 32);
+	}
+};
+
+// One generator per seed; consecutive shuffles continue the same sequence
+class KeyShuffler
+{
+	std::variant<SplitMix64, std::mt19937_64> m_rng;
+public:
+	KeyShuffler(KeySchedule schedule, uint64_t seed)
+		: m_rng(schedule == KeySchedule::Legacy
+			? std::variant<SplitMix64, std::mt19937_64>(std::in_place_type<std::mt19937_64>, seed)
+			: std::variant<SplitMix64, std::mt19937_64>(std::in_place_type<SplitMix64>, seed)) {}
+
+	// V1: for i from size - 1 down to 1, swap element i with element Below(i + 1)
+	template <class It>
+	void Shuffle(It begin, It end) {
+		if (auto* legacy = std::get_if<std::mt19937_64>(&m_rng)) {
+			std::shuffle(begin, end, *legacy);
+			return;
+		}
+
+		auto& rng = std::get<SplitMix64>(m_rng);
+		for (auto i = end - begin - 1; i > 0; --i) {
+			auto j = rng.Below(static_cast<uint32_t>(i + 1));
+			using std::swap;
+			swap(begin[i], begin[j]);
+		}
+	}
+};
@@ -0,0 +1,1024 @@
+#include "PreparedKey.hpp"
+#include "Cipher.hpp"
+#include "../../Utils/CpuFeatures.hpp"
+#include "../../Utils/Parallel.hpp"
+#include "../../Utils/StringUtils.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#if CPU_FEATURES_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+	// Destinations for the encode and decode loops
+	struct StringOutput {
+		std::string& out;
+
+		void Append(const char* begin, const char* end) { out.append(begin, end); }
+		void Append(char32_t c) { string_utils::append_utf8(out, c); }
+	};
+
+	struct BufferOutput {
+		char* out;
+
+		void Append(const char* begin, const char* end) {
+			std::memcpy(out, begin, end - begin);
+			out += end - begin;
+		}
+		void Append(char32_t c) { out = string_utils::write_utf8(out, c); }
+	};
+
+	// BufferOutput that refuses to run past the end of its buffer
+	struct LimitedOutput {
+		char* out;
+		char* end;
+
+		void Append(const char* begin, const char* last) {
+			if (last - begin > end - out)
+				throw std::length_error("PreparedKey::Decode: output buffer is too small");
+			std::memcpy(out, begin, last - begin);
+			out += last - begin;
+		}
+		void Append(char32_t c) {
+			if (static_cast<size_t>(end - out) < string_utils::utf8_length(c))
+				throw std::length_error("PreparedKey::Decode: output buffer is too small");
+			out = string_utils::write_utf8(out, c);
+		}
+	};
+
+	struct CountingOutput {
+		size_t size = 0;
+
+		void Append(const char* begin, const char* end) { size += end - begin; }
+		void Append(char32_t c) { size += string_utils::utf8_length(c); }
+	};
+
+	// One counter per alphabet symbol, kept on the stack for alphabets of common size
+	class SymbolCounters
+	{
+		std::array<size_t, 128> m_local;
+		std::pmr::vector<size_t> m_heap;
+		size_t* m_data;
+		size_t m_size;
+	public:
+		SymbolCounters(size_t size, std::pmr::memory_resource* resource) : m_heap(resource), m_size(size) {
+			if (size > m_local.size())
+				m_heap.resize(size);
+			m_data = size > m_local.size() ? m_heap.data() : m_local.data();
+			Reset();
+		}
+
+		void Reset() { std::fill(m_data, m_data + m_size, 0); }
+		size_t* Data() { return m_data; }
+	};
+
+#if CPU_FEATURES_X86
+	// Decodes up to 8 separator-free tokens from the 32 bytes at p, taken as 4-byte tokens of two
+	// 2-byte UTF-8 symbols below AlphabetIndex::DirectRange. Stops at the first token that is not
+	// one or does not map to a 2-byte symbol, writes the UTF-8 of the symbols before it to out
+	// and returns their count.
+	CPU_TARGET("avx2")
+	size_t decode_pairs_avx2(const char* p, const uint32_t* direct, const char32_t* decode, uint32_t size, char* out) {
+		const __m256i ones = _mm256_set1_epi32(-1);
+		__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		__m256i valid = _mm256_cmpeq_epi32(_mm256_and_si256(v, _mm256_set1_epi32(static_cast<int>(0xC0E0C0E0))),
+			_mm256_set1_epi32(static_cast<int>(0x80C080C0)));
+
+		__m256i first = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(v, _mm256_set1_epi32(0x1F)), 6),
+			_mm256_and_si256(_mm256_srli_epi32(v, 8), _mm256_set1_epi32(0x3F)));
+		__m256i second = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(v, 16), _mm256_set1_epi32(0x1F)), 6),
+			_mm256_and_si256(_mm256_srli_epi32(v, 24), _mm256_set1_epi32(0x3F)));
+		// Overlong forms are left to the scalar decoder, which rejects them
+		const __m256i low = _mm256_set1_epi32(0x7F);
+		const __m256i high = _mm256_set1_epi32(static_cast<int>(AlphabetIndex::DirectRange));
+		valid = _mm256_and_si256(valid, _mm256_and_si256(_mm256_cmpgt_epi32(first, low), _mm256_cmpgt_epi32(high, first)));
+		valid = _mm256_and_si256(valid, _mm256_and_si256(_mm256_cmpgt_epi32(second, low), _mm256_cmpgt_epi32(high, second)));
+
+		__m256i r = _mm256_mask_i32gather_epi32(ones, reinterpret_cast<const int*>(direct), first, valid, 4);
+		valid = _mm256_andnot_si256(_mm256_cmpeq_epi32(r, ones), valid);
+		__m256i c = _mm256_mask_i32gather_epi32(ones, reinterpret_cast<const int*>(direct), second, valid, 4);
+		valid = _mm256_andnot_si256(_mm256_cmpeq_epi32(c, ones), valid);
+
+		__m256i index = _mm256_add_epi32(_mm256_mullo_epi32(r, _mm256_set1_epi32(static_cast<int>(size))), c);
+		__m256i symbol = _mm256_mask_i32gather_epi32(ones, reinterpret_cast<const int*>(decode), index, valid, 4);
+		__m256i twoBytes = _mm256_and_si256(
+			_mm256_cmpeq_epi32(_mm256_and_si256(symbol, _mm256_set1_epi32(~0x7FF)), _mm256_setzero_si256()),
+			_mm256_cmpgt_epi32(symbol, low));
+		valid = _mm256_and_si256(valid, twoBytes);
+
+		__m256i lead = _mm256_or_si256(_mm256_srli_epi32(symbol, 6), _mm256_set1_epi32(0xC0));
+		__m256i cont = _mm256_or_si256(_mm256_and_si256(symbol, _mm256_set1_epi32(0x3F)), _mm256_set1_epi32(0x80));
+		__m256i utf8 = _mm256_or_si256(lead, _mm256_slli_epi32(cont, 8));
+		utf8 = _mm256_permute4x64_epi64(_mm256_packus_epi32(utf8, utf8), 0x08);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(utf8));
+
+		return std::countr_one(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(valid))));
+	}
+#endif
+
+	// Wrapped form: the escape in front of a letter that stands for a passthrough whitespace
+	// character or the escape itself
+	constexpr char WrapEscape = '\\';
+	constexpr std::string_view WrapEscaped = " \t\n\v\f\r\\";
+	constexpr std::string_view WrapLetters = "stnvfr\\";
+
+	// First byte at or after p that is a space, a control character or WrapEscape
+	const char* find_wrap_candidate_scalar(const char* p, const char* end) {
+		while (p != end && static_cast<unsigned char>(*p) > 0x20 && *p != WrapEscape)
+			++p;
+		return p;
+	}
+
+#if CPU_FEATURES_X86
+	CPU_TARGET("avx2")
+	const char* find_wrap_candidate_avx2(const char* p, const char* end) {
+		const __m256i space = _mm256_set1_epi8(0x20);
+		const __m256i escape = _mm256_set1_epi8(WrapEscape);
+		for (; end - p >= 32; p += 32) {
+			__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			__m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(v, space), v), _mm256_cmpeq_epi8(v, escape));
+			if (uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits)))
+				return p + std::countr_zero(mask);
+		}
+		return find_wrap_candidate_scalar(p, end);
+	}
+#endif
+}
+
+PreparedKey::PreparedKey(AlphabetIndex alphabet, std::u32string separator, std::u32string const& keyword,
+	KeySchedule schedule)
+	: m_alphabet(std::move(alphabet)), m_separator(std::move(separator)), m_schedule(schedule)
+{
+	std::u32string uniqueKey = GetUniqueKey(keyword);
+	m_table = BuildTable(uniqueKey);
+	// The decode table depends on the unique key and the schedule only
+	m_fingerprint = static_cast<uint32_t>(
+		SplitMix64(string_utils::str_hash(uniqueKey) * 31 + static_cast<uint32_t>(schedule)).Next() >> 32);
+	BuildEncodeSchedule(m_table, keyword);
+	// The encode schedule depends on the whole keyword
+	m_keyDigest = static_cast<uint32_t>(
+		SplitMix64(string_utils::str_hash(keyword) * 31 + static_cast<uint32_t>(schedule)).Next() >> 32);
+	// Seeded apart from the fingerprint and digest, which are stored in the clear next to ciphertext
+	m_positionKey = SplitMix64(string_utils::str_hash(keyword) ^ 0x706F736974696F6Eull).Next();
+
+	m_minSymbolBytes = 4;
+	m_maxSymbolBytes = 1;
+	bool directPairs = true;
+	for (auto c : m_alphabet.Symbols()) {
+		m_minSymbolBytes = std::min(m_minSymbolBytes, string_utils::utf8_length(c));
+		m_maxSymbolBytes = std::max(m_maxSymbolBytes, string_utils::utf8_length(c));
+		directPairs = directPairs && c < AlphabetIndex::DirectRange;
+	}
+	// The vector decoder only takes 2-byte symbols it can look up directly; for any other
+	// alphabet it would stop at the first token every time and only cost time
+	m_pairDecode = m_separator.empty() && m_minSymbolBytes == 2 && m_maxSymbolBytes == 2 && directPairs;
+}
+
+PreparedKey::PreparedKey(Cipher const& config, std::string const& keyword)
+	: PreparedKey(config.m_alphabet, config.m_separator, string_utils::utf8_to_u32(keyword), config.m_schedule)
+{
+}
+
+size_t PreparedKey::Table::MemoryUsage() const
+{
+	size_t bytes = sizeof(Table);
+	for (auto const& row : table)
+		bytes += sizeof(row) + row.capacity() * sizeof(char32_t);
+	for (auto const& key : rowKeys)
+		bytes += sizeof(key) + key.capacity() * sizeof(char32_t);
+	for (auto const& key : colKeys)
+		bytes += sizeof(key) + key.capacity() * sizeof(char32_t);
+
+	return bytes + decode.capacity() * sizeof(char32_t) +
+		homophones.capacity() * sizeof(size_t) +
+		tokens.capacity() * sizeof(tokens[0]) +
+		tokenBytes.capacity() + tokenOffsets.capacity() * sizeof(uint32_t) +
+		tokenSymbols.capacity() * sizeof(char32_t);
+}
+
+PreparedKey::Table PreparedKey::BuildTable(std::u32string const& key) 
+{
+	std::vector<bool> used(m_alphabet.Size(), false);
+	for (auto c : key)
+		used[m_alphabet.Find(c)] = true;
+
+	std::u32string base = key;
+	for (auto c : m_alphabet.Symbols()) {
+		uint32_t pos = m_alphabet.Find(c);
+		if (!used[pos]) {
+			used[pos] = true;
+			base += c;
+		}
+	}
+
+	int total = static_cast<int>(base.size());
+	int cols = static_cast<int>(ceil(sqrt(total)));
+	int rows = static_cast<int>(ceil(static_cast<double>(total) / cols));
+
+	Table table{
+		std::vector<std::vector<char32_t>>(rows, std::vector<char32_t>(cols, U'\0')),
+		std::vector<std::u32string>(rows),
+		std::vector<std::u32string>(cols),
+		{}, {}, {}, {}, {}, {}
+	};
+
+	int k = 0;
+	for (int i = 0; i < rows && k < total; i++)
+		for (int j = 0; j < cols && k < total; j++)
+			table.table[i][j] = base[k++];
+
+	auto generateTableKeys = [&](const std::u32string& key, int count,
+                             std::span<const char32_t> symbols) -> std::vector<std::u32string>
+	{
+		KeyShuffler rng(m_schedule, string_utils::str_hash(key));
+
+		std::vector<char32_t> local_symbols(symbols.begin(), symbols.end());
+		rng.Shuffle(local_symbols.begin(), local_symbols.end());
+
+		std::vector<std::u32string> res;
+		res.reserve(count);
+
+		size_t idx = 0;
+		for (int i = 0; i < count; ++i) {
+			char32_t a = local_symbols[idx++];
+			char32_t b = local_symbols[idx++];
+			res.emplace_back(std::u32string{a, b});
+
+			if (idx + 1 >= local_symbols.size()) {
+				rng.Shuffle(local_symbols.begin(), local_symbols.end());
+				idx = 0;
+			}
+		}
+
+		return res;
+	};
+	KeyShuffler rng(m_schedule, string_utils::str_hash(key));
+	std::vector<char32_t> symbols(m_alphabet.Symbols().begin(), m_alphabet.Symbols().end());
+	rng.Shuffle(symbols.begin(), symbols.end());
+	size_t half = symbols.size() / 2;
+
+	std::span<const char32_t> row_symbols(symbols.data(), half);
+	std::span<const char32_t> col_symbols(symbols.data() + half, symbols.size() - half);
+
+	table.rowKeys = generateTableKeys(key, rows, row_symbols);
+	table.colKeys = generateTableKeys(key + U"_col", cols, col_symbols);
+
+	BuildDecodeTable(table);
+
+	return table;
+}
+
+void PreparedKey::BuildDecodeTable(Table& table)
+{
+	size_t size = m_alphabet.Size();
+	table.decode.assign(size * size, NoSymbol);
+
+	// The first cell whose key combination matches a token wins, as in the original table walk
+	for (size_t i = 0; i < table.table.size(); ++i) {
+		for (size_t j = 0; j < table.table[i].size(); ++j) {
+			for (char32_t rc : table.rowKeys[i]) {
+				for (char32_t cc : table.colKeys[j]) {
+					size_t r = m_alphabet.Find(rc);
+					size_t c = m_alphabet.Find(cc);
+
+					auto& direct = table.decode[r * size + c];
+					if (direct == NoSymbol) direct = table.table[i][j];
+
+					auto& reverse = table.decode[c * size + r];
+					if (reverse == NoSymbol) reverse = table.table[i][j];
+				}
+			}
+		}
+	}
+}
+
+void PreparedKey::BuildEncodeSchedule(Table& table, std::u32string const& key)
+{
+	table.homophones.assign(1, 0);
+	table.tokens.clear();
+
+	for (auto c : m_alphabet.Symbols()) {
+		size_t first = table.tokens.size();
+
+		for (size_t i = 0; i < table.table.size(); ++i) {
+			for (size_t j = 0; j < table.table[i].size(); ++j) {
+				if (table.table[i][j] == c) {
+					const auto& r = table.rowKeys[i];
+					const auto& col = table.colKeys[j];
+
+					for (auto rc : r)
+						for (auto cc : col) {
+							table.tokens.push_back({ rc, cc });
+							table.tokens.push_back({ cc, rc });
+						}
+				}
+			}
+		}
+
+		KeyShuffler rng(m_schedule, string_utils::str_hash(key + std::u32string(1, c)));
+		rng.Shuffle(table.tokens.begin() + first, table.tokens.end());
+
+		table.homophones.push_back(table.tokens.size());
+	}
+
+	std::string separator = string_utils::u32_to_utf8(m_separator);
+	table.tokenBytes.clear();
+	table.tokenOffsets.assign(1, 0);
+	for (auto const& token : table.tokens) {
+		string_utils::append_utf8(table.tokenBytes, token[0]);
+		string_utils::append_utf8(table.tokenBytes, token[1]);
+		table.tokenBytes += separator;
+		table.tokenOffsets.push_back(static_cast<uint32_t>(table.tokenBytes.size()));
+	}
+
+	size_t size = m_alphabet.Size();
+	table.tokenSymbols.clear();
+	table.tokenSymbols.reserve(table.tokens.size());
+	for (auto const& token : table.tokens)
+		table.tokenSymbols.push_back(table.decode[m_alphabet.Find(token[0]) * size + m_alphabet.Find(token[1])]);
+}
+
+std::u32string PreparedKey::GetUniqueKey(std::u32string const& key)
+{
+	std::u32string res;
+	std::vector<bool> used(m_alphabet.Size(), false);
+	for (auto c : key) {
+		uint32_t pos = m_alphabet.Find(c);
+		if (pos != AlphabetIndex::NotFound && !used[pos]) {
+			used[pos] = true;
+			res += c;
+		}
+	}
+	return res;
+}
+
+std::vector<const char*> PreparedKey::SplitText(std::string_view text, size_t parts)
+{
+	const char* begin = text.data();
+	const char* end = begin + text.size();
+	parts = std::clamp<size_t>(text.size() / ParallelChunkSize, 1, std::max<size_t>(parts, 1));
+
+	std::vector<const char*> ends;
+	ends.reserve(parts);
+	for (size_t i = 1; i < parts; ++i) {
+		const char* cut = begin + text.size() / parts * i;
+		// Never split a sequence: a valid one holds no lead byte after its first
+		for (int k = 0; k < 3 && cut != end && (static_cast<unsigned char>(*cut) & 0xC0) == 0x80; ++k)
+			++cut;
+		if (ends.empty() || cut > ends.back())
+			ends.push_back(cut);
+	}
+	ends.push_back(end);
+	return ends;
+}
+
+size_t PreparedKey::CountSymbols(const char* it, const char* end, size_t* counts) const
+{
+	size_t passthrough = 0;
+	while (it != end) {
+		const char* start = it;
+		uint32_t pos = m_alphabet.Find(string_utils::next_code_point(it, end));
+		if (pos != AlphabetIndex::NotFound)
+			counts[pos]++;
+		else
+			passthrough += it - start;
+	}
+	return passthrough;
+}
+
+size_t PreparedKey::TokenBytes(size_t pos, size_t from, size_t count) const
+{
+	// Homophones of a symbol are used in a cycle, so whole cycles cost the bytes of all of them
+	size_t first = m_table.homophones[pos];
+	size_t cycle = m_table.homophones[pos + 1] - first;
+	size_t cycleBytes = m_table.tokenOffsets[first + cycle] - m_table.tokenOffsets[first];
+
+	auto bytesBefore = [&](size_t n) {
+		return n / cycle * cycleBytes + m_table.tokenOffsets[first + n % cycle] - m_table.tokenOffsets[first];
+	};
+	return bytesBefore(from + count) - bytesBefore(from);
+}
+
+size_t PreparedKey::PositionalBytes(const char* it, const char* end, uint64_t offset) const
+{
+	const char* begin = it;
+	size_t bytes = 0;
+	while (it != end) {
+		const char* start = it;
+		uint32_t pos = m_alphabet.Find(string_utils::next_code_point(it, end));
+		if (pos == AlphabetIndex::NotFound) {
+			bytes += it - start;
+			continue;
+		}
+
+		size_t token = PickToken(pos, nullptr, offset + (start - begin));
+		bytes += m_table.tokenOffsets[token + 1] - m_table.tokenOffsets[token];
+	}
+	return bytes;
+}
+
+template <class Output>
+void PreparedKey::EncodeInto(const char* it, const char* end, size_t* counters, uint64_t offset, Output& out) const
+{
+	const char* begin = it;
+	while (it != end) {
+		const char* start = it;
+		uint32_t pos = m_alphabet.Find(string_utils::next_code_point(it, end));
+		if (pos == AlphabetIndex::NotFound) {
+			out.Append(start, it);
+			continue;
+		}
+
+		size_t token = PickToken(pos, counters, offset + (start - begin));
+		out.Append(m_table.tokenBytes.data() + m_table.tokenOffsets[token],
+			m_table.tokenBytes.data() + m_table.tokenOffsets[token + 1]);
+	}
+}
+
+void PreparedKey::EncodeRange(const char* it, const char* end, size_t* counters, uint64_t offset, std::string& out) const
+{
+	StringOutput output{ out };
+	EncodeInto(it, end, counters, offset, output);
+}
+
+size_t PreparedKey::EncodedSize(std::string_view text, std::pmr::memory_resource* resource) const
+{
+	if (!SizesFromCounts())
+		return PositionalBytes(text.data(), text.data() + text.size(), 0);
+
+	SymbolCounters counts(m_alphabet.Size(), resource);
+	size_t size = CountSymbols(text.data(), text.data() + text.size(), counts.Data());
+	for (size_t pos = 0; pos < m_alphabet.Size(); ++pos)
+		size += TokenBytes(pos, 0, counts.Data()[pos]);
+	return size;
+}
+
+void PreparedKey::WriteEncoded(std::string_view text, char* out, std::pmr::memory_resource* resource) const
+{
+	SymbolCounters counters(m_alphabet.Size(), resource);
+	BufferOutput output{ out };
+	EncodeInto(text.data(), text.data() + text.size(), counters.Data(), 0, output);
+}
+
+size_t PreparedKey::Encode(std::string_view text, std::span<char> out, std::pmr::memory_resource* resource) const
+{
+	size_t size = EncodedSize(text, resource);
+	if (out.size() < size)
+		throw std::length_error("PreparedKey::Encode: output buffer is too small");
+
+	WriteEncoded(text, out.data(), resource);
+	return size;
+}
+
+void PreparedKey::Encode(std::string_view text, std::string& out, std::pmr::memory_resource* resource) const
+{
+	out.resize(EncodedSize(text, resource));
+	WriteEncoded(text, out.data(), resource);
+}
+
+std::string PreparedKey::Encode(std::string_view text) const
+{
+	std::string result;
+	Encode(text, result);
+	return result;
+}
+
+std::pmr::string PreparedKey::Encode(std::string_view text, std::pmr::memory_resource* resource) const
+{
+	std::pmr::string result(EncodedSize(text, resource), '\0', resource);
+	WriteEncoded(text, result.data(), resource);
+	return result;
+}
+
+template <class Output>
+void PreparedKey::DecodeInto(const char* it, const char* end, DecodeState& state, Output& out) const
+{
+	size_t size = m_alphabet.Size();
+
+	// Finish the token the previous range cut off
+	while (it != end && (state.skip || state.pending)) {
+		char32_t c = string_utils::next_code_point(it, end);
+		if (state.skip) {
+			state.skip--;
+		}
+		else if (state.first == AlphabetIndex::NotFound) {
+			out.Append(state.symbol);
+			state.symbol = c;
+			state.first = m_alphabet.Find(c);
+		}
+		else {
+			uint32_t second = m_alphabet.Find(c);
+			if (second != AlphabetIndex::NotFound) {
+				char32_t symbol = m_table.decode[state.first * size + second];
+				if (symbol != NoSymbol)
+					out.Append(symbol);
+			}
+			state.pending = false;
+			state.skip = m_separator.size();
+		}
+	}
+
+	// Separator-free tokens sit at fixed strides between passthrough runs, so runs of them
+	// can be decoded several at a time
+	bool pairs = m_pairDecode && string_utils::get_simd_level() == string_utils::simd_level::avx2;
+
+	// Mirrors the original code point loop: tokens start every 2 + separator code points,
+	// non-alphabet code points in front of a token pass through, and the last code point
+	// of the text is never emitted
+	while (it != end) {
+		if (pairs) {
+			it = DecodePairs(it, end, out);
+			if (it == end)
+				return;
+		}
+
+		const char* start = it;
+		char32_t c = string_utils::next_code_point(it, end);
+		uint32_t first = m_alphabet.Find(c);
+		while (first == AlphabetIndex::NotFound && it != end) {
+			out.Append(start, it);
+			start = it;
+			c = string_utils::next_code_point(it, end);
+			first = m_alphabet.Find(c);
+		}
+
+		if (it == end) {
+			state.pending = true;
+			state.symbol = c;
+			state.first = first;
+			return;
+		}
+
+		uint32_t second = m_alphabet.Find(string_utils::next_code_point(it, end));
+		if (second != AlphabetIndex::NotFound) {
+			char32_t symbol = m_table.decode[first * size + second];
+			if (symbol != NoSymbol)
+				out.Append(symbol);
+		}
+
+		size_t k = 0;
+		for (; k < m_separator.size() && it != end; ++k)
+			string_utils::next_code_point(it, end);
+		state.skip = m_separator.size() - k;
+	}
+}
+
+template <class Output>
+const char* PreparedKey::DecodePairs(const char* it, const char* end, Output& out) const
+{
+#if CPU_FEATURES_X86
+	char buffer[16];
+	while (end - it >= 32) {
+		size_t count = decode_pairs_avx2(it, m_alphabet.DirectTable().data(), m_table.decode.data(),
+			static_cast<uint32_t>(m_alphabet.Size()), buffer);
+		out.Append(buffer, buffer + 2 * count);
+		it += 4 * count;
+		if (count < 8)
+			break;
+	}
+#endif
+	return it;
+}
+
+void PreparedKey::DecodeRange(const char* it, const char* end, DecodeState& state, std::string& out) const
+{
+	StringOutput output{ out };
+	DecodeInto(it, end, state, output);
+}
+
+std::string PreparedKey::EncodeParallel(std::string_view text, size_t threads) const
+{
+	if (threads == 0) threads = parallel::default_threads();
+	// A few chunks per thread even out the load when text density varies
+	std::vector<const char*> ends = SplitText(text, threads * 4);
+	size_t chunks = ends.size();
+	if (chunks == 1 || threads == 1)
+		return Encode(text);
+
+	auto chunkBegin = [&](size_t i) { return i == 0 ? text.data() : ends[i - 1]; };
+
+	// Every chunk picks its homophones from its own offsets: encode them apart and join the results
+	if (m_schedule == KeySchedule::Positional) {
+		std::vector<std::string> parts(chunks);
+		parallel::for_each(chunks, threads, [&](size_t i) {
+			parts[i].reserve(2 * (ends[i] - chunkBegin(i)));
+			EncodeRange(chunkBegin(i), ends[i], nullptr, chunkBegin(i) - text.data(), parts[i]);
+		});
+
+		size_t total = 0;
+		for (auto const& part : parts)
+			total += part.size();
+		std::string result;
+		result.reserve(total);
+		for (auto const& part : parts)
+			result += part;
+		return result;
+	}
+
+	// Homophone choice depends on how often each symbol occurred before, so every chunk
+	// starts from the counts of all chunks in front of it. The counts also give the exact
+	// size of every chunk's output, which is then written in place.
+	size_t size = m_alphabet.Size();
+	std::vector<size_t> counts(chunks * size, 0);
+	std::vector<size_t> passthrough(chunks);
+	parallel::for_each(chunks, threads, [&](size_t i) {
+		passthrough[i] = CountSymbols(chunkBegin(i), ends[i], &counts[i * size]);
+	});
+
+	std::vector<size_t> counters(chunks * size, 0);
+	std::vector<size_t> offsets(chunks + 1, 0);
+	for (size_t i = 0; i < chunks; ++i) {
+		size_t bytes = passthrough[i];
+		for (size_t pos = 0; pos < size; ++pos) {
+			size_t start = counters[i * size + pos];
+			bytes += TokenBytes(pos, start, counts[i * size + pos]);
+			if (i + 1 < chunks)
+				counters[(i + 1) * size + pos] = start + counts[i * size + pos];
+		}
+		offsets[i + 1] = offsets[i] + bytes;
+	}
+
+	std::string result(offsets[chunks], '\0');
+	parallel::for_each(chunks, threads, [&](size_t i) {
+		BufferOutput output{ result.data() + offsets[i] };
+		EncodeInto(chunkBegin(i), ends[i], &counters[i * size], chunkBegin(i) - text.data(), output);
+	});
+
+	return result;
+}
+
+uint32_t PreparedKey::GetDecodePhase(DecodeState const& state)
+{
+	if (state.pending)
+		return state.first == AlphabetIndex::NotFound ? PhasePassthrough : PhaseSymbol;
+	return state.skip ? PhaseSymbol + static_cast<uint32_t>(state.skip) : PhaseReady;
+}
+
+PreparedKey::DecodeState PreparedKey::MakeDecodeState(uint32_t phase, const char* begin, const char* it) const
+{
+	DecodeState state;
+	if (phase == PhasePassthrough || phase == PhaseSymbol) {
+		const char* last = it;
+		while (last != begin && (static_cast<unsigned char>(*--last) & 0xC0) == 0x80) {}
+		state.pending = true;
+		state.symbol = string_utils::next_code_point(last, it);
+		state.first = m_alphabet.Find(state.symbol);
+	}
+	else if (phase > PhaseSymbol) {
+		state.skip = phase - PhaseSymbol;
+	}
+	return state;
+}
+
+uint32_t PreparedKey::GuessDecodePhase(const char* begin, const char* it, const char* end) const
+{
+	uint32_t count = static_cast<uint32_t>(m_separator.size()) + 3;
+	size_t size = m_alphabet.Size();
+
+	// A pending code point is the one in front of it, so only one of the two pending phases is possible
+	DecodeState pending = MakeDecodeState(PhaseSymbol, begin, it);
+	uint32_t previous = pending.first;
+	uint32_t excluded = previous == AlphabetIndex::NotFound ? PhaseSymbol : PhasePassthrough;
+
+	std::vector<uint32_t> phases(count);
+	std::vector<size_t> scores(count, 0);
+	for (uint32_t p = 0; p < count; ++p)
+		phases[p] = p;
+
+	const char* stop = it + std::min<size_t>(end - it, ResyncLength);
+	while (it < stop) {
+		uint32_t pos = m_alphabet.Find(string_utils::next_code_point(it, end));
+		for (uint32_t p = 0; p < count; ++p) {
+			uint32_t& phase = phases[p];
+			if (phase == PhaseSymbol) {
+				// The pending symbol is always the previous code point
+				if (previous != AlphabetIndex::NotFound && pos != AlphabetIndex::NotFound &&
+					m_table.decode[previous * size + pos] != NoSymbol)
+					scores[p]++;
+				phase = m_separator.empty() ? PhaseReady : PhaseSymbol + static_cast<uint32_t>(m_separator.size());
+			}
+			else if (phase > PhaseSymbol) {
+				phase = phase == PhaseSymbol + 1 ? PhaseReady : phase - 1;
+			}
+			else {
+				phase = pos == AlphabetIndex::NotFound ? PhasePassthrough : PhaseSymbol;
+			}
+		}
+		previous = pos;
+	}
+
+	uint32_t best = PhaseReady;
+	for (uint32_t p = 0; p < count; ++p)
+		if (p != excluded && scores[p] > scores[best])
+			best = p;
+	return best;
+}
+
+size_t PreparedKey::DecodedSize(std::string_view text) const
+{
+	DecodeState state;
+	CountingOutput output;
+	DecodeInto(text.data(), text.data() + text.size(), state, output);
+	return output.size;
+}
+
+size_t PreparedKey::DecodedSizeBound(std::string_view text) const
+{
+	// Passthrough code points are copied as they are, and every symbol written takes at least
+	// two alphabet code points of input
+	size_t perToken = 2 * m_minSymbolBytes;
+	return text.size() * ((m_maxSymbolBytes + perToken - 1) / perToken) + m_maxSymbolBytes;
+}
+
+size_t PreparedKey::Decode(std::string_view text, std::span<char> out) const
+{
+	if (out.size() < DecodedSizeBound(text) && out.size() < DecodedSize(text))
+		throw std::length_error("PreparedKey::Decode: output buffer is too small");
+
+	DecodeState state;
+	BufferOutput output{ out.data() };
+	DecodeInto(text.data(), text.data() + text.size(), state, output);
+	return output.out - out.data();
+}
+
+size_t PreparedKey::Decode(std::string_view text, std::span<char> out,
+	std::function<void(std::string_view)> const& onBlock) const
+{
+	constexpr size_t BlockSize = 64 << 10;
+
+	DecodeState state;
+	LimitedOutput output{ out.data(), out.data() + out.size() };
+	const char* it = text.data();
+	const char* end = it + text.size();
+	while (it != end) {
+		const char* blockEnd = it + std::min<size_t>(BlockSize, end - it);
+		for (int k = 0; k < 3 && blockEnd != end && (static_cast<unsigned char>(*blockEnd) & 0xC0) == 0x80; ++k)
+			++blockEnd;
+
+		// Bounds are only checked on blocks that could reach the end of out; a code point carried
+		// over from the previous block adds at most 4 bytes
+		char* written = output.out;
+		if (DecodedSizeBound(std::string_view(it, blockEnd - it)) + 4 <= static_cast<size_t>(output.end - output.out)) {
+			BufferOutput unchecked{ output.out };
+			DecodeInto(it, blockEnd, state, unchecked);
+			output.out = unchecked.out;
+		}
+		else
+			DecodeInto(it, blockEnd, state, output);
+		onBlock(std::string_view(written, output.out - written));
+		it = blockEnd;
+	}
+	return output.out - out.data();
+}
+
+void PreparedKey::Decode(std::string_view text, std::string& out) const
+{
+	out.resize(DecodedSizeBound(text));
+	out.resize(Decode(text, std::span<char>(out)));
+}
+
+std::string PreparedKey::Decode(std::string_view text) const
+{
+	std::string result;
+	Decode(text, result);
+	return result;
+}
+
+std::pmr::string PreparedKey::Decode(std::string_view text, std::pmr::memory_resource* resource) const
+{
+	std::pmr::string result(DecodedSizeBound(text), '\0', resource);
+	result.resize(Decode(text, std::span<char>(result)));
+	return result;
+}
+
+std::string PreparedKey::DecodeFixed(std::string_view text) const
+{
+	if (!m_separator.empty())
+		throw std::logic_error("PreparedKey::DecodeFixed: key has a separator");
+
+	std::string result(DecodedSizeBound(text), '\0');
+	DecodeState state;
+	BufferOutput output{ result.data() };
+	DecodeInto(text.data(), text.data() + text.size(), state, output);
+	// A token never starts with a passthrough code point, so one still pending ends the text
+	if (state.pending && state.first == AlphabetIndex::NotFound)
+		output.Append(state.symbol);
+	result.resize(output.out - result.data());
+	return result;
+}
+
+void PreparedKey::CheckWrapped() const
+{
+	if (!m_separator.empty())
+		throw std::logic_error("PreparedKey: the wrapped form needs a key without separator");
+	if (m_alphabet.Contains(static_cast<char32_t>(WrapEscape)))
+		throw std::logic_error("PreparedKey: the wrapped form needs an alphabet without '\\'");
+}
+
+std::string PreparedKey::EncodeWrapped(std::string_view text, size_t tokensPerLine) const
+{
+	CheckWrapped();
+	if (tokensPerLine == 0)
+		throw std::invalid_argument("PreparedKey::EncodeWrapped: tokensPerLine must be positive");
+
+	SymbolCounters counters(m_alphabet.Size(), std::pmr::get_default_resource());
+	std::string result;
+	result.reserve(text.size() * 2 + text.size() / (tokensPerLine * 2));
+	size_t line = 0;
+
+	const char* it = text.data();
+	const char* end = it + text.size();
+	while (it != end) {
+		const char* start = it;
+		char32_t c = string_utils::next_code_point(it, end);
+		uint32_t pos = m_alphabet.Find(c);
+		if (pos == AlphabetIndex::NotFound) {
+			size_t escaped = c < 0x80 ? WrapEscaped.find(static_cast<char>(c)) : std::string_view::npos;
+			if (escaped != std::string_view::npos) {
+				result += WrapEscape;
+				result += WrapLetters[escaped];
+			}
+			else
+				result.append(start, it);
+			continue;
+		}
+
+		if (line == tokensPerLine) {
+			result += '\n';
+			line = 0;
+		}
+		size_t token = PickToken(pos, counters.Data(), start - text.data());
+		result.append(m_table.tokenBytes.data() + m_table.tokenOffsets[token],
+			m_table.tokenBytes.data() + m_table.tokenOffsets[token + 1]);
+		line++;
+	}
+	return result;
+}
+
+std::string PreparedKey::DecodeWrapped(std::string_view text) const
+{
+	CheckWrapped();
+
+	// ASCII whitespace outside the alphabet only lays the text out
+	std::array<bool, 0x21> skipped{};
+	for (char c : WrapEscaped.substr(0, WrapEscaped.size() - 1))
+		skipped[static_cast<unsigned char>(c)] = !m_alphabet.Contains(static_cast<char32_t>(c));
+	auto isSkipped = [&](char c) { return static_cast<unsigned char>(c) <= 0x20 && skipped[static_cast<unsigned char>(c)]; };
+	auto findCandidate = find_wrap_candidate_scalar;
+#if CPU_FEATURES_X86
+	if (string_utils::get_simd_level() == string_utils::simd_level::avx2)
+		findCandidate = find_wrap_candidate_avx2;
+#endif
+
+	std::string result(DecodedSizeBound(text), '\0');
+	DecodeState state;
+	BufferOutput output{ result.data() };
+
+	// Runs between skipped bytes are decoded in place; a code point split by a line break
+	// is put together in carry first
+	char carry[4];
+	size_t carried = 0;
+	auto decode = [&](const char* it, const char* end) {
+		if (carried) {
+			size_t length = string_utils::utf8_sequence_length(static_cast<unsigned char>(carry[0]));
+			while (carried < length && it != end)
+				carry[carried++] = *it++;
+			if (carried < length)
+				return;
+			DecodeInto(carry, carry + carried, state, output);
+			carried = 0;
+		}
+		const char* whole = end - string_utils::incomplete_utf8_suffix(it, end);
+		DecodeInto(it, whole, state, output);
+		for (; whole != end; ++whole)
+			carry[carried++] = *whole;
+	};
+
+	const char* it = text.data();
+	const char* end = it + text.size();
+	while (it != end) {
+		// Spaces and control characters that are alphabet symbols or passthrough stay in the run
+		const char* stop = findCandidate(it, end);
+		while (stop != end && *stop != WrapEscape && !isSkipped(*stop))
+			stop = findCandidate(stop + 1, end);
+		decode(it, stop);
+		if (stop == end)
+			break;
+
+		it = stop + 1;
+		if (*stop == WrapEscape) {
+			while (it != end && isSkipped(*it))
+				++it;
+			size_t letter = it == end ? std::string_view::npos : WrapLetters.find(*it);
+			if (letter == std::string_view::npos)
+				throw std::invalid_argument("PreparedKey::DecodeWrapped: invalid escape");
+			// Between tokens the character is simply written, as DecodeInto would
+			if (carried || state.pending || state.skip)
+				decode(&WrapEscaped[letter], &WrapEscaped[letter] + 1);
+			else
+				output.Append(static_cast<char32_t>(WrapEscaped[letter]));
+			++it;
+		}
+	}
+	if (carried)
+		DecodeInto(carry, carry + carried, state, output);
+
+	// As in DecodeFixed, a passthrough code point still pending ends the text
+	if (state.pending && state.first == AlphabetIndex::NotFound)
+		output.Append(state.symbol);
+	result.resize(output.out - result.data());
+	return result;
+}
+
+std::string PreparedKey::DecodeParallel(std::string_view text, size_t threads) const
+{
+	if (threads == 0) threads = parallel::default_threads();
+	std::vector<const char*> ends = SplitText(text, threads * 4);
+	size_t segments = ends.size();
+	if (segments == 1 || threads == 1)
+		return Decode(text);
+
+	auto segmentBegin = [&](size_t i) { return i == 0 ? text.data() : ends[i - 1]; };
+
+	// A segment cut at an arbitrary code point may start inside a token or separator. Each one
+	// is decoded from a guessed entry state while the true states are only known in order
+	// afterwards. A wrong guess usually falls into step within the first few code points,
+	// so the head of the segment is redone; only if the states still differ after it is
+	// the whole segment decoded again.
+	struct Segment {
+		uint32_t guess = PhaseReady;
+		const char* headEnd = nullptr;
+		DecodeState headState;
+		size_t headSize = 0;
+		DecodeState exit;
+		std::string text;
+	};
+
+	std::vector<Segment> parts(segments);
+	parallel::for_each(segments, threads, [&](size_t i) {
+		auto& part = parts[i];
+		const char* begin = segmentBegin(i);
+		part.headEnd = begin + std::min<size_t>(ends[i] - begin, ResyncLength);
+		while (part.headEnd != ends[i] && (static_cast<unsigned char>(*part.headEnd) & 0xC0) == 0x80)
+			++part.headEnd;
+
+		if (i != 0)
+			part.guess = GuessDecodePhase(text.data(), begin, ends[i]);
+		part.exit = MakeDecodeState(part.guess, text.data(), begin);
+		part.text.reserve((ends[i] - begin) / 2);
+		DecodeRange(begin, part.headEnd, part.exit, part.text);
+		part.headState = part.exit;
+		part.headSize = part.text.size();
+		DecodeRange(part.headEnd, ends[i], part.exit, part.text);
+	});
+
+	for (size_t i = 1; i < segments; ++i) {
+		auto& part = parts[i];
+		DecodeState state = parts[i - 1].exit;
+		if (GetDecodePhase(state) == part.guess)
+			continue;
+
+		std::string head;
+		DecodeRange(segmentBegin(i), part.headEnd, state, head);
+		if (GetDecodePhase(state) == GetDecodePhase(part.headState)) {
+			part.text.replace(0, part.headSize, head);
+			continue;
+		}
+
+		part.text = std::move(head);
+		DecodeRange(part.headEnd, ends[i], state, part.text);
+		part.exit = state;
+	}
+
+	std::vector<size_t> offsets(segments + 1, 0);
+	for (size_t i = 0; i < segments; ++i)
+		offsets[i + 1] = offsets[i] + parts[i].text.size();
+
+	std::string result(offsets[segments], '\0');
+	parallel::for_each(segments, threads, [&](size_t i) {
+		std::memcpy(result.data() + offsets[i], parts[i].text.data(), parts[i].text.size());
+		std::string().swap(parts[i].text);
+	});
+
+	return result;
+}
+
+size_t PreparedKey::MemoryUsage() const
+{
+	return sizeof(PreparedKey) + m_table.MemoryUsage() + m_alphabet.MemoryUsage() +
+		m_separator.capacity() * sizeof(char32_t);
+}
+
+std::string PreparedKey::GetAlphabet() const
+{
+	return string_utils::u32_to_utf8(m_alphabet.Symbols());
+}
+
+std::string PreparedKey::GetSeparator() const
+{
+	return string_utils::u32_to_utf8(m_separator);
+}
\ No newline at end of file
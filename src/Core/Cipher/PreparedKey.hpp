@@ -0,0 +1,211 @@
+#pragma once
+#include "AlphabetIndex.hpp"
+#include "KeySchedule.hpp"
+
+#include <array>
+#include <functional>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class BinaryFormat;
+class Cipher;
+class CompressedFormat;
+class Container;
+class PreparedKeyBench;
+class SeekIndex;
+class StreamEncoder;
+class StreamDecoder;
+
+// Immutable key tables for one (alphabet, separator, keyword) configuration.
+// All public members are const, so one instance can be shared between threads.
+class PreparedKey
+{
+	friend class BinaryFormat;
+	friend class Cipher;
+	friend class CompressedFormat;
+	friend class Container;
+	friend class PreparedKeyBench;		// times the steps of key preparation one at a time
+	friend class SeekIndex;
+	friend class StreamEncoder;
+	friend class StreamDecoder;
+
+	struct Table {
+		std::vector<std::vector<char32_t>> table;
+		std::vector<std::u32string> rowKeys;
+		std::vector<std::u32string> colKeys;
+		// token (alphabet position of first symbol * alphabet size + position of second) -> plaintext symbol
+		std::vector<char32_t> decode;
+		// shuffled homophones of the symbol at alphabet position p are tokens[homophones[p]..homophones[p + 1])
+		std::vector<size_t> homophones;
+		std::vector<std::array<char32_t, 2>> tokens;
+		// UTF-8 form of tokens[t] followed by the separator is tokenBytes[tokenOffsets[t]..tokenOffsets[t + 1])
+		std::string tokenBytes;
+		std::vector<uint32_t> tokenOffsets;
+		// what Decode turns tokens[t] into, NoSymbol for nothing
+		std::vector<char32_t> tokenSymbols;
+
+		size_t MemoryUsage() const;
+	};
+
+	static constexpr char32_t NoSymbol = static_cast<char32_t>(-1);
+
+	// DecodeState reduced to what decides how later code points are read: 0 = ready,
+	// 1 = pending passthrough, 2 = pending alphabet symbol, 2 + k = k separator code points to skip
+	static constexpr uint32_t PhaseReady = 0;
+	static constexpr uint32_t PhasePassthrough = 1;
+	static constexpr uint32_t PhaseSymbol = 2;
+	// Bytes a parallel decode looks at to guess the phase of a segment, and within which
+	// decodes from different phases are expected to fall into step
+	static constexpr size_t ResyncLength = 4096;
+	// Inputs are split for parallel work into pieces of at least this many bytes
+	static constexpr size_t ParallelChunkSize = 256 << 10;
+
+	// Where Decode stopped at the end of a range
+	struct DecodeState {
+		size_t skip = 0;			// separator code points still to skip
+		bool pending = false;		// symbol was read, but whether it is the last code point is not known yet
+		char32_t symbol = 0;
+		uint32_t first = 0;			// alphabet position of symbol
+	};
+
+private:
+	AlphabetIndex m_alphabet;
+	std::u32string m_separator;
+	KeySchedule m_schedule;
+	Table m_table;
+	size_t m_minSymbolBytes;		// UTF-8 lengths of the shortest and longest alphabet symbol
+	size_t m_maxSymbolBytes;
+	bool m_pairDecode;				// no separator and only 2-byte symbols DecodePairs can look up
+	uint32_t m_fingerprint;
+	uint32_t m_keyDigest;			// fingerprint of the whole keyword, see SeekIndex
+	uint64_t m_positionKey;			// hash key of KeySchedule::Positional
+
+	Table BuildTable(std::u32string const& key);
+	void BuildDecodeTable(Table& table);
+	void BuildEncodeSchedule(Table& table, std::u32string const& key);
+	std::u32string GetUniqueKey(std::u32string const& key);
+
+	// Cuts text into up to `parts` ranges of similar size at code point boundaries, returns the range ends
+	static std::vector<const char*> SplitText(std::string_view text, size_t parts);
+
+	// Adds the number of occurrences of every alphabet symbol in [it, end) to counts and
+	// returns the bytes of the code points outside the alphabet
+	size_t CountSymbols(const char* it, const char* end, size_t* counts) const;
+	// Bytes written for `count` occurrences of the symbol at pos, starting at homophone counter `from`
+	size_t TokenBytes(size_t pos, size_t from, size_t count) const;
+	// Bytes Encode writes for [it, end) at plaintext offset `offset` under KeySchedule::Positional
+	size_t PositionalBytes(const char* it, const char* end, uint64_t offset) const;
+	// Whether CountSymbols and TokenBytes give output sizes. Under KeySchedule::Positional they
+	// do only when all tokens are equally long, otherwise PositionalBytes has to.
+	bool SizesFromCounts() const {
+		return m_schedule != KeySchedule::Positional || m_minSymbolBytes == m_maxSymbolBytes;
+	}
+
+	// Token for the symbol at alphabet position pos found at plaintext byte offset `offset`:
+	// the next homophone of its cycle, counted in counters, or under KeySchedule::Positional
+	// one picked by a hash of (pos, offset), which leaves counters alone
+	size_t PickToken(size_t pos, size_t* counters, uint64_t offset) const {
+		size_t first = m_table.homophones[pos];
+		size_t count = m_table.homophones[pos + 1] - first;
+		if (m_schedule != KeySchedule::Positional)
+			return first + counters[pos]++ % count;
+		uint64_t hash = SplitMix64::Mix(m_positionKey + offset * 0x9E3779B97F4A7C15ull + pos);
+		return first + static_cast<size_t>(((hash >> 32) * count) >> 32);
+	}
+	// Writes exactly EncodedSize(text) bytes to out
+	void WriteEncoded(std::string_view text, char* out, std::pmr::memory_resource* resource) const;
+
+	// offset is the plaintext byte offset of it, which only KeySchedule::Positional uses
+	template <class Output>
+	void EncodeInto(const char* it, const char* end, size_t* counters, uint64_t offset, Output& out) const;
+	template <class Output>
+	void DecodeInto(const char* it, const char* end, DecodeState& state, Output& out) const;
+	// Vector decode of the separator-free tokens at it made of 2-byte symbols; returns where it
+	// stopped, at a token boundary
+	template <class Output>
+	const char* DecodePairs(const char* it, const char* end, Output& out) const;
+	// Encodes whole code points of [it, end) found at plaintext byte offset `offset`, counters
+	// holds one homophone counter per alphabet symbol
+	void EncodeRange(const char* it, const char* end, size_t* counters, uint64_t offset, std::string& out) const;
+	// Decodes whole code points of [it, end) continuing from state; a pending symbol left at the
+	// very end of the text is dropped, like the last code point in Decode
+	void DecodeRange(const char* it, const char* end, DecodeState& state, std::string& out) const;
+
+	// Throws std::logic_error unless the key can write the wrapped form
+	void CheckWrapped() const;
+
+	static uint32_t GetDecodePhase(DecodeState const& state);
+	// State for phase at position it of a text starting at begin; a pending symbol is the code point before it
+	DecodeState MakeDecodeState(uint32_t phase, const char* begin, const char* it) const;
+	// Decodes a short stretch after it from every phase at once and returns the one yielding the
+	// most tokens that map to a symbol, the true phase for well-formed ciphertext
+	uint32_t GuessDecodePhase(const char* begin, const char* it, const char* end) const;
+public:
+	PreparedKey(Cipher const& config, std::string const& keyword);
+	PreparedKey(AlphabetIndex alphabet, std::u32string separator, std::u32string const& keyword,
+		KeySchedule schedule = KeySchedule::Legacy);
+
+	std::string Encode(std::string_view text) const;
+	std::string Decode(std::string_view text) const;
+
+	// Temporaries and the result come from resource
+	std::pmr::string Encode(std::string_view text, std::pmr::memory_resource* resource) const;
+	std::pmr::string Decode(std::string_view text, std::pmr::memory_resource* resource) const;
+
+	// Exact output sizes; EncodedSize takes one counting pass, DecodedSize a decode without output
+	size_t EncodedSize(std::string_view text, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+	size_t DecodedSize(std::string_view text) const;
+	// Output never longer than Decode(text), found without decoding
+	size_t DecodedSizeBound(std::string_view text) const;
+
+	// Replace the contents of out with the result. Once out has grown to the needed capacity
+	// these allocate nothing, except for homophone counters of alphabets over 128 symbols.
+	void Encode(std::string_view text, std::string& out,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+	void Decode(std::string_view text, std::string& out) const;
+
+	// Write the result to the front of out and return its size. out must hold at least
+	// EncodedSize(text) / DecodedSize(text) bytes, otherwise std::length_error is thrown.
+	size_t Encode(std::string_view text, std::span<char> out,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+	size_t Decode(std::string_view text, std::span<char> out) const;
+	// Like Decode into a span, but out only has to hold the result: std::length_error is thrown
+	// before anything is written past it. Every block written is passed to onBlock while it is
+	// still in cache.
+	size_t Decode(std::string_view text, std::span<char> out,
+		std::function<void(std::string_view)> const& onBlock) const;
+
+	// Decode for a key with an empty separator that also keeps a passthrough code point at the
+	// very end, which Decode drops; it reverses Encode as far as the key's decode table is
+	// unambiguous. Throws std::logic_error on a key with a separator.
+	std::string DecodeFixed(std::string_view text) const;
+
+	// Fixed-width form in lines of tokensPerLine tokens, for a key with an empty separator and an
+	// alphabet without '\\'. Passthrough ASCII whitespace and '\\' are written as '\\' and one of
+	// "stnvfr\\", so any ASCII whitespace outside the alphabet only lays the text out: DecodeWrapped
+	// skips it wherever it is, also inside tokens, and gives what DecodeFixed gives for the same
+	// tokens without layout.
+	std::string EncodeWrapped(std::string_view text, size_t tokensPerLine) const;
+	std::string DecodeWrapped(std::string_view text) const;
+
+	// Same output as Encode, computed on up to `threads` threads (0 = one per core). Under
+	// KeySchedule::Positional the pieces are encoded straight away, without a counting pass first.
+	std::string EncodeParallel(std::string_view text, size_t threads = 0) const;
+	// Same output as Decode, computed on up to `threads` threads (0 = one per core). Segments
+	// start from a guessed decode state; one guessed wrong whose decode has not fallen into step
+	// after ResyncLength bytes is decoded again, on the calling thread, once the states in front
+	// of it are known. Well-formed ciphertext rarely needs that, but at worst, with every guess
+	// wrong and never in step, the text is decoded twice and the second pass is serial.
+	std::string DecodeParallel(std::string_view text, size_t threads = 0) const;
+
+	size_t MemoryUsage() const;
+
+	std::string GetAlphabet() const;
+	std::string GetSeparator() const;
+	KeySchedule GetKeySchedule() const { return m_schedule; }
+	// 32-bit digest of the table the keyword produces, equal for every keyword that decodes alike
+	uint32_t GetFingerprint() const { return m_fingerprint; }
+};
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "SeekIndex.hpp"
+#include "../../Utils/StringUtils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+static const char Magic[4] = { 'S', 'U', 'B', 'I' };
+
+static void PutLittle(char* out, uint64_t value, size_t bytes)
+{
+	for (size_t i = 0; i < bytes; ++i)
+		out[i] = static_cast<char>(value >> (8 * i));
+}
+
+static uint64_t GetLittle(const char* in, size_t bytes)
+{
+	uint64_t value = 0;
+	for (size_t i = 0; i < bytes; ++i)
+		value |= static_cast<uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+	return value;
+}
+
+static bool IsContinuation(std::string_view text, uint64_t offset)
+{
+	return offset < text.size() && (static_cast<unsigned char>(text[offset]) & 0xC0) == 0x80;
+}
+
+SeekIndex SeekIndex::Build(PreparedKey const& key, std::string_view text, size_t interval)
+{
+	if (interval == 0)
+		throw std::invalid_argument("SeekIndex: interval must be positive");
+
+	size_t size = key.m_alphabet.Size();
+	SeekIndex index;
+	index.m_alphabetHash = string_utils::str_hash(key.m_alphabet.Symbols());
+	index.m_keyDigest = key.m_keyDigest;
+	index.m_separator = string_utils::u32_to_utf8(key.m_separator);
+	if (index.m_separator.size() > UINT16_MAX)
+		throw std::invalid_argument("SeekIndex: separator is too long");
+	index.m_interval = interval;
+	index.m_checkpoints.push_back({ 0, 0, std::vector<uint64_t>(size, 0) });
+
+	// Ciphertext offsets follow from the symbol counts of each stretch, as in EncodedSize
+	std::vector<size_t> counts(size);
+	const char* it = text.data();
+	const char* end = it + text.size();
+	while (it != end) {
+		const char* start = it;
+		for (size_t n = 0; n < interval && it != end; ++n) {
+			++it;
+			while (it != end && (static_cast<unsigned char>(*it) & 0xC0) == 0x80)
+				++it;
+		}
+
+		std::fill(counts.begin(), counts.end(), 0);
+		Checkpoint next = index.m_checkpoints.back();
+		next.ciphertext += key.CountSymbols(start, it, counts.data());
+		for (size_t pos = 0; pos < size; ++pos) {
+			next.ciphertext += key.TokenBytes(pos, next.counters[pos], counts[pos]);
+			next.counters[pos] += counts[pos];
+		}
+		if (!key.SizesFromCounts())
+			next.ciphertext = index.m_checkpoints.back().ciphertext + key.PositionalBytes(start, it, next.plaintext);
+		next.plaintext += it - start;
+		index.m_checkpoints.push_back(std::move(next));
+	}
+	return index;
+}
+
+void SeekIndex::CheckKey(PreparedKey const& key) const
+{
+	if (m_alphabetHash != string_utils::str_hash(key.m_alphabet.Symbols()) ||
+		m_checkpoints.front().counters.size() != key.m_alphabet.Size())
+		throw std::invalid_argument("SeekIndex: built with a different alphabet");
+	if (m_separator != string_utils::u32_to_utf8(key.m_separator))
+		throw std::invalid_argument("SeekIndex: built with a different separator");
+	if (m_keyDigest != key.m_keyDigest)
+		throw std::invalid_argument("SeekIndex: wrong key");
+}
+
+size_t SeekIndex::Find(uint64_t plaintext) const
+{
+	auto it = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), plaintext,
+		[](uint64_t offset, Checkpoint const& checkpoint) { return offset < checkpoint.plaintext; });
+	return (it - m_checkpoints.begin()) - 1;
+}
+
+std::string SeekIndex::DecodeSlice(PreparedKey const& key, std::string_view ciphertext, uint64_t begin, uint64_t end) const
+{
+	CheckKey(key);
+	if (begin > end || end > PlaintextSize())
+		throw std::out_of_range("SeekIndex: range outside the plaintext");
+	if (ciphertext.size() != CiphertextSize())
+		throw std::invalid_argument("SeekIndex: ciphertext length does not match the index");
+	if (begin == end)
+		return {};
+
+	// Every checkpoint is at a token boundary, so decoding starts there from a fresh state
+	size_t first = Find(begin);
+	size_t last = first;
+	while (m_checkpoints[last].plaintext < end)
+		++last;
+	Checkpoint const& from = m_checkpoints[first];
+	Checkpoint const& to = m_checkpoints[last];
+
+	std::string result;
+	result.reserve(to.plaintext - from.plaintext);
+	PreparedKey::DecodeState state;
+	key.DecodeRange(ciphertext.data() + from.ciphertext, ciphertext.data() + to.ciphertext, state, result);
+	// Unlike at the end of a whole ciphertext, a passthrough code point pending here is part of the plaintext
+	if (state.pending && state.first == AlphabetIndex::NotFound)
+		string_utils::append_utf8(result, state.symbol);
+
+	if (result.size() != to.plaintext - from.plaintext)
+		throw std::runtime_error("SeekIndex: ciphertext does not match the index");
+	return result.substr(begin - from.plaintext, end - begin);
+}
+
+std::string SeekIndex::EncodeSlice(PreparedKey const& key, std::string_view text, uint64_t begin, uint64_t end,
+	uint64_t* offset) const
+{
+	CheckKey(key);
+	if (begin > end || end > text.size() || end > PlaintextSize())
+		throw std::out_of_range("SeekIndex: range outside the plaintext");
+	if (IsContinuation(text, begin) || IsContinuation(text, end))
+		throw std::invalid_argument("SeekIndex: range does not start and end at code points");
+
+	// Counters and offset at begin: the checkpoint's, moved on over the stretch up to begin
+	Checkpoint const& from = m_checkpoints[Find(begin)];
+	size_t size = key.m_alphabet.Size();
+	std::vector<size_t> counts(size, 0);
+	std::vector<size_t> counters(from.counters.begin(), from.counters.end());
+	uint64_t position = from.ciphertext + key.CountSymbols(text.data() + from.plaintext, text.data() + begin, counts.data());
+	for (size_t pos = 0; pos < size; ++pos) {
+		position += key.TokenBytes(pos, counters[pos], counts[pos]);
+		counters[pos] += counts[pos];
+	}
+	if (!key.SizesFromCounts())
+		position = from.ciphertext + key.PositionalBytes(text.data() + from.plaintext, text.data() + begin, from.plaintext);
+	if (offset)
+		*offset = position;
+
+	std::string result;
+	key.EncodeRange(text.data() + begin, text.data() + end, counters.data(), begin, result);
+	return result;
+}
+
+std::string SeekIndex::Serialize() const
+{
+	size_t alphabet = m_checkpoints.front().counters.size();
+	size_t checkpointSize = 16 + 8 * alphabet;
+	std::string result(FixedHeaderSize + m_separator.size() + m_checkpoints.size() * checkpointSize, '\0');
+
+	char* p = result.data();
+	std::memcpy(p, Magic, sizeof(Magic));
+	p[4] = static_cast<char>(Version);
+	PutLittle(p + 6, m_separator.size(), 2);
+	PutLittle(p + 8, m_alphabetHash, 8);
+	PutLittle(p + 16, m_keyDigest, 4);
+	PutLittle(p + 20, alphabet, 4);
+	PutLittle(p + 24, m_interval, 8);
+	PutLittle(p + 32, m_checkpoints.size(), 8);
+	std::memcpy(p + FixedHeaderSize, m_separator.data(), m_separator.size());
+
+	p += FixedHeaderSize + m_separator.size();
+	for (auto const& checkpoint : m_checkpoints) {
+		PutLittle(p, checkpoint.plaintext, 8);
+		PutLittle(p + 8, checkpoint.ciphertext, 8);
+		for (size_t pos = 0; pos < alphabet; ++pos)
+			PutLittle(p + 16 + 8 * pos, checkpoint.counters[pos], 8);
+		p += checkpointSize;
+	}
+	return result;
+}
+
+SeekIndex SeekIndex::Parse(std::string_view data)
+{
+	if (data.size() < FixedHeaderSize || std::memcmp(data.data(), Magic, sizeof(Magic)) != 0)
+		throw std::invalid_argument("SeekIndex: not an index");
+
+	const char* p = data.data();
+	if (static_cast<uint8_t>(p[4]) != Version)
+		throw std::invalid_argument("SeekIndex: unsupported version " + std::to_string(static_cast<uint8_t>(p[4])));
+
+	SeekIndex index;
+	size_t separatorBytes = GetLittle(p + 6, 2);
+	index.m_alphabetHash = GetLittle(p + 8, 8);
+	index.m_keyDigest = static_cast<uint32_t>(GetLittle(p + 16, 4));
+	size_t alphabet = GetLittle(p + 20, 4);
+	index.m_interval = GetLittle(p + 24, 8);
+	uint64_t count = GetLittle(p + 32, 8);
+
+	size_t checkpointSize = 16 + 8 * alphabet;
+	size_t body = data.size() - FixedHeaderSize;
+	if (body < separatorBytes || count == 0 || (body - separatorBytes) / checkpointSize != count ||
+		(body - separatorBytes) % checkpointSize != 0)
+		throw std::invalid_argument("SeekIndex: truncated or oversized index");
+	index.m_separator.assign(p + FixedHeaderSize, separatorBytes);
+
+	p += FixedHeaderSize + separatorBytes;
+	index.m_checkpoints.resize(count);
+	for (auto& checkpoint : index.m_checkpoints) {
+		checkpoint.plaintext = GetLittle(p, 8);
+		checkpoint.ciphertext = GetLittle(p + 8, 8);
+		checkpoint.counters.resize(alphabet);
+		for (size_t pos = 0; pos < alphabet; ++pos)
+			checkpoint.counters[pos] = GetLittle(p + 16 + 8 * pos, 8);
+		p += checkpointSize;
+	}
+
+	// Offsets only grow, and the first checkpoint is the start of the text
+	auto const& first = index.m_checkpoints.front();
+	bool ordered = first.plaintext == 0 && first.ciphertext == 0;
+	for (size_t i = 1; i < count && ordered; ++i)
+		ordered = index.m_checkpoints[i].plaintext > index.m_checkpoints[i - 1].plaintext &&
+			index.m_checkpoints[i].ciphertext >= index.m_checkpoints[i - 1].ciphertext;
+	if (!ordered)
+		throw std::invalid_argument("SeekIndex: checkpoints out of order");
+	return index;
+}
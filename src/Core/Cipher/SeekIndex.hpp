@@ -0,0 +1,75 @@
+#pragma once
+#include "PreparedKey.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Checkpoints into a ciphertext, meant to be kept next to it in a sidecar file: every `interval`
+// plaintext code points, the plaintext and ciphertext byte offsets and the homophone counters
+// Encode has at that point. A plaintext range is then decoded or re-encoded at the cost of the
+// range and at most one interval on either side, instead of everything in front of it.
+// Sidecar layout, integers little-endian:
+//   0  "SUBI"
+//   4  u8  version (2)
+//   5  u8  reserved, 0
+//   6  u16 separator bytes n
+//   8  u64 alphabet hash
+//  16  u32 key digest
+//  20  u32 alphabet size a
+//  24  u64 interval
+//  32  u64 checkpoints m
+//  40  separator, n bytes
+//  40 + n  m checkpoints: u64 plaintext offset, u64 ciphertext offset, a x u64 counters
+// The counters only fit the homophone schedule they were counted with, which is built from the
+// whole keyword. Keywords with the same unique letters share a fingerprint but not that schedule,
+// so the index stores a digest of the whole keyword and the key schedule instead.
+class SeekIndex
+{
+public:
+	struct Checkpoint {
+		uint64_t plaintext = 0;
+		uint64_t ciphertext = 0;
+		std::vector<uint64_t> counters;		// per alphabet position: occurrences so far
+	};
+
+	static constexpr uint8_t Version = 2;
+	static constexpr size_t FixedHeaderSize = 40;
+	static constexpr size_t DefaultInterval = 1 << 16;
+
+private:
+	uint64_t m_alphabetHash = 0;
+	uint32_t m_keyDigest = 0;
+	std::string m_separator;
+	uint64_t m_interval = DefaultInterval;
+	std::vector<Checkpoint> m_checkpoints;		// the first at offset 0, the last at the end of the text
+
+	SeekIndex() = default;
+
+	// Throws std::invalid_argument unless key is the one the index was built with
+	void CheckKey(PreparedKey const& key) const;
+	// Last checkpoint at or before plaintext offset
+	size_t Find(uint64_t plaintext) const;
+public:
+	// Takes one counting pass over text, the plaintext of PreparedKey::Encode
+	static SeekIndex Build(PreparedKey const& key, std::string_view text, size_t interval = DefaultInterval);
+
+	std::string Serialize() const;
+	// Throws std::invalid_argument on data that is not a well-formed index
+	static SeekIndex Parse(std::string_view data);
+
+	// Bytes [begin, end) of the plaintext that ciphertext, the whole output of Encode, was
+	// encoded from. Throws std::out_of_range outside the plaintext.
+	std::string DecodeSlice(PreparedKey const& key, std::string_view ciphertext, uint64_t begin, uint64_t end) const;
+	// What Encode(text) writes for text[begin, end), where begin and end fall on code point
+	// boundaries; offset receives where that starts in the whole ciphertext. Only text from the
+	// checkpoint before begin up to end is read.
+	std::string EncodeSlice(PreparedKey const& key, std::string_view text, uint64_t begin, uint64_t end,
+		uint64_t* offset = nullptr) const;
+
+	uint64_t GetInterval() const { return m_interval; }
+	std::vector<Checkpoint> const& GetCheckpoints() const { return m_checkpoints; }
+	uint64_t PlaintextSize() const { return m_checkpoints.back().plaintext; }
+	uint64_t CiphertextSize() const { return m_checkpoints.back().ciphertext; }
+};
@@ -0,0 +1,68 @@
+#include "StreamDecoder.hpp"
+#include "../../Utils/StringUtils.hpp"
+
+#include <algorithm>
+
+StreamDecoder::StreamDecoder(std::shared_ptr<const PreparedKey> key, Sink sink, size_t bufferSize)
+	: m_key(std::move(key)), m_sink(std::move(sink)), m_bufferSize(std::max<size_t>(bufferSize, 16))
+{
+	m_buffer.reserve(m_bufferSize);
+}
+
+void StreamDecoder::Write(std::string_view chunk)
+{
+	const char* it = chunk.data();
+	const char* end = it + chunk.size();
+
+	if (!m_pending.empty()) {
+		size_t length = string_utils::utf8_sequence_length(static_cast<unsigned char>(m_pending[0]));
+		size_t take = std::min<size_t>(length - m_pending.size(), end - it);
+		m_pending.append(it, take);
+		it += take;
+		if (m_pending.size() < length)
+			return;
+
+		m_key->DecodeRange(m_pending.data(), m_pending.data() + m_pending.size(), m_state, m_buffer);
+		m_pending.clear();
+	}
+
+	const char* tail = end - string_utils::incomplete_utf8_suffix(it, end);
+	DecodeSlices(it, tail);
+	m_pending.assign(tail, end);
+}
+
+void StreamDecoder::DecodeSlices(const char* it, const char* end)
+{
+	while (it != end) {
+		const char* stop = it + std::min<size_t>(end - it, m_bufferSize);
+		for (int i = 0; i < 3 && stop != end && (static_cast<unsigned char>(*stop) & 0xC0) == 0x80; ++i)
+			--stop;
+
+		m_key->DecodeRange(it, stop, m_state, m_buffer);
+		it = stop;
+
+		if (m_buffer.size() >= m_bufferSize)
+			Flush();
+	}
+}
+
+void StreamDecoder::Finish()
+{
+	// Decode throws on a truncated last code point as well
+	if (!m_pending.empty()) {
+		std::string pending = std::move(m_pending);
+		m_pending.clear();
+		m_key->DecodeRange(pending.data(), pending.data() + pending.size(), m_state, m_buffer);
+	}
+	m_state = {};
+	Flush();
+}
+
+void StreamDecoder::Flush()
+{
+	if (m_buffer.empty())
+		return;
+
+	m_sink(m_buffer);
+	m_buffer.clear();
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "PreparedKey.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Decodes a ciphertext that arrives in arbitrary byte chunks and hands the plaintext to a sink.
+// Tokens, separators and UTF-8 sequences cut at a chunk edge are completed from the next
+// chunk, so the output is the same as PreparedKey::Decode of the concatenated input.
+class StreamDecoder
+{
+public:
+	using Sink = std::function<void(std::string_view)>;
+
+	static constexpr size_t DefaultBufferSize = 64 << 10;
+
+private:
+	std::shared_ptr<const PreparedKey> m_key;
+	Sink m_sink;
+	size_t m_bufferSize;
+
+	PreparedKey::DecodeState m_state;
+	std::string m_pending;		// leading bytes of a code point cut off by the previous chunk
+	std::string m_buffer;
+
+	void DecodeSlices(const char* it, const char* end);
+	void Flush();
+public:
+	StreamDecoder(std::shared_ptr<const PreparedKey> key, Sink sink, size_t bufferSize = DefaultBufferSize);
+
+	// Throws utf8::exception on malformed input; output of earlier chunks may already be in the sink
+	void Write(std::string_view chunk);
+	// Flushes the sink. As in Decode, the last code point of the ciphertext is not emitted.
+	void Finish();
+};
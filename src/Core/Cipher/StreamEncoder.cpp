@@ -0,0 +1,75 @@
+#include "StreamEncoder.hpp"
+#include "../../Utils/StringUtils.hpp"
+
+#include <algorithm>
+
+StreamEncoder::StreamEncoder(std::shared_ptr<const PreparedKey> key, Sink sink, size_t bufferSize)
+	: m_key(std::move(key)), m_sink(std::move(sink)), m_bufferSize(std::max<size_t>(bufferSize, 16))
+{
+	m_counters.assign(m_key->m_alphabet.Size(), 0);
+	m_buffer.reserve(m_bufferSize);
+}
+
+void StreamEncoder::Write(std::string_view chunk)
+{
+	const char* it = chunk.data();
+	const char* end = it + chunk.size();
+
+	if (!m_pending.empty()) {
+		size_t length = string_utils::utf8_sequence_length(static_cast<unsigned char>(m_pending[0]));
+		size_t take = std::min<size_t>(length - m_pending.size(), end - it);
+		m_pending.append(it, take);
+		it += take;
+		if (m_pending.size() < length)
+			return;
+
+		EncodeRange(m_pending.data(), m_pending.data() + m_pending.size());
+		m_pending.clear();
+	}
+
+	const char* tail = end - string_utils::incomplete_utf8_suffix(it, end);
+	EncodeSlices(it, tail);
+	m_pending.assign(tail, end);
+}
+
+void StreamEncoder::EncodeRange(const char* it, const char* end)
+{
+	m_key->EncodeRange(it, end, m_counters.data(), m_offset, m_buffer);
+	m_offset += end - it;
+}
+
+void StreamEncoder::EncodeSlices(const char* it, const char* end)
+{
+	// Slices keep the buffer near its nominal size however large the chunk is
+	while (it != end) {
+		const char* stop = it + std::min<size_t>(end - it, m_bufferSize);
+		// Step back to a code point boundary, continuation bytes past 3 are malformed anyway
+		for (int i = 0; i < 3 && stop != end && (static_cast<unsigned char>(*stop) & 0xC0) == 0x80; ++i)
+			--stop;
+
+		EncodeRange(it, stop);
+		it = stop;
+
+		if (m_buffer.size() >= m_bufferSize)
+			Flush();
+	}
+}
+
+void StreamEncoder::Finish()
+{
+	if (!m_pending.empty()) {
+		std::string pending = std::move(m_pending);
+		m_pending.clear();
+		EncodeRange(pending.data(), pending.data() + pending.size());
+	}
+	Flush();
+}
+
+void StreamEncoder::Flush()
+{
+	if (m_buffer.empty())
+		return;
+
+	m_sink(m_buffer);
+	m_buffer.clear();
+}
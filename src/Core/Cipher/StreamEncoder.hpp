@@ -0,0 +1,41 @@
+#pragma once
+#include "PreparedKey.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Encodes a text that arrives in arbitrary UTF-8 chunks and hands the result to a sink.
+// Homophone counters and code points split between chunks carry over, so the output is
+// the same as PreparedKey::Encode of the concatenated input, and memory use does not
+// grow with the input.
+class StreamEncoder
+{
+public:
+	using Sink = std::function<void(std::string_view)>;
+
+	static constexpr size_t DefaultBufferSize = 64 << 10;
+
+private:
+	std::shared_ptr<const PreparedKey> m_key;
+	Sink m_sink;
+	size_t m_bufferSize;
+
+	std::vector<size_t> m_counters;
+	uint64_t m_offset = 0;		// plaintext bytes encoded so far
+	std::string m_pending;		// leading bytes of a code point cut off by the previous chunk
+	std::string m_buffer;
+
+	void EncodeRange(const char* it, const char* end);
+	void EncodeSlices(const char* it, const char* end);
+	void Flush();
+public:
+	StreamEncoder(std::shared_ptr<const PreparedKey> key, Sink sink, size_t bufferSize = DefaultBufferSize);
+
+	// Throws utf8::exception on malformed input; output of earlier chunks may already be in the sink
+	void Write(std::string_view chunk);
+	// Encodes what is left and flushes the sink. A code point still incomplete here throws.
+	void Finish();
+};
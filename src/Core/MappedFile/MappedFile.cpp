@@ -0,0 +1,226 @@
+#include "MappedFile.hpp"
+
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static std::system_error LastError(const char* what)
+{
+#ifdef _WIN32
+	return std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+#else
+	return std::system_error(errno, std::system_category(), what);
+#endif
+}
+
+#ifdef _WIN32
+MappedFile MappedFile::OpenRead(std::filesystem::path const& path)
+{
+	MappedFile file;
+	file.m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file.m_file == INVALID_HANDLE_VALUE) {
+		file.m_file = nullptr;
+		throw LastError("MappedFile: cannot open input file");
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file.m_file, &size))
+		throw LastError("MappedFile: cannot read file size");
+	file.m_size = static_cast<size_t>(size.QuadPart);
+
+	// Empty files cannot be mapped, and need not be
+	if (file.m_size == 0)
+		return file;
+
+	file.m_mapping = CreateFileMappingW(file.m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!file.m_mapping)
+		throw LastError("MappedFile: cannot map input file");
+
+	file.m_data = static_cast<char*>(MapViewOfFile(file.m_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!file.m_data)
+		throw LastError("MappedFile: cannot map input file");
+	return file;
+}
+
+MappedFile MappedFile::Create(std::filesystem::path const& path, size_t size)
+{
+	MappedFile file;
+	file.m_writable = true;
+	file.m_size = size;
+	file.m_file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file.m_file == INVALID_HANDLE_VALUE) {
+		file.m_file = nullptr;
+		throw LastError("MappedFile: cannot create output file");
+	}
+
+	if (size == 0)
+		return file;
+
+	// Mapping past the end of the file extends it to the mapped size
+	LARGE_INTEGER mappedSize;
+	mappedSize.QuadPart = static_cast<LONGLONG>(size);
+	file.m_mapping = CreateFileMappingW(file.m_file, nullptr, PAGE_READWRITE,
+		mappedSize.HighPart, mappedSize.LowPart, nullptr);
+	if (!file.m_mapping)
+		throw LastError("MappedFile: cannot map output file");
+
+	file.m_data = static_cast<char*>(MapViewOfFile(file.m_mapping, FILE_MAP_WRITE, 0, 0, 0));
+	if (!file.m_data)
+		throw LastError("MappedFile: cannot map output file");
+	return file;
+}
+
+void MappedFile::Unmap()
+{
+	if (m_data)
+		UnmapViewOfFile(m_data);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+	m_data = nullptr;
+	m_mapping = nullptr;
+}
+
+void MappedFile::Close(size_t size)
+{
+	if (m_writable && m_data)
+		FlushViewOfFile(m_data, 0);
+	Unmap();
+
+	if (m_file && m_writable && size != m_size) {
+		LARGE_INTEGER end;
+		end.QuadPart = static_cast<LONGLONG>(size);
+		if (!SetFilePointerEx(m_file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file)) {
+			CloseHandle(m_file);
+			m_file = nullptr;
+			throw LastError("MappedFile: cannot truncate output file");
+		}
+	}
+
+	if (m_file)
+		CloseHandle(m_file);
+	m_file = nullptr;
+	m_size = 0;
+}
+#else
+MappedFile MappedFile::OpenRead(std::filesystem::path const& path)
+{
+	MappedFile file;
+	file.m_file = open(path.c_str(), O_RDONLY);
+	if (file.m_file < 0)
+		throw LastError("MappedFile: cannot open input file");
+
+	struct stat info;
+	if (fstat(file.m_file, &info) != 0)
+		throw LastError("MappedFile: cannot read file size");
+	file.m_size = static_cast<size_t>(info.st_size);
+
+	// Empty files cannot be mapped, and need not be
+	if (file.m_size == 0)
+		return file;
+
+	void* data = mmap(nullptr, file.m_size, PROT_READ, MAP_SHARED, file.m_file, 0);
+	if (data == MAP_FAILED)
+		throw LastError("MappedFile: cannot map input file");
+	file.m_data = static_cast<char*>(data);
+	madvise(data, file.m_size, MADV_SEQUENTIAL);
+	return file;
+}
+
+MappedFile MappedFile::Create(std::filesystem::path const& path, size_t size)
+{
+	MappedFile file;
+	file.m_writable = true;
+	file.m_size = size;
+	file.m_file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (file.m_file < 0)
+		throw LastError("MappedFile: cannot create output file");
+
+	if (size == 0)
+		return file;
+
+	if (ftruncate(file.m_file, static_cast<off_t>(size)) != 0)
+		throw LastError("MappedFile: cannot size output file");
+
+	void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file.m_file, 0);
+	if (data == MAP_FAILED)
+		throw LastError("MappedFile: cannot map output file");
+	file.m_data = static_cast<char*>(data);
+	return file;
+}
+
+void MappedFile::Unmap()
+{
+	if (m_data)
+		munmap(m_data, m_size);
+	m_data = nullptr;
+}
+
+void MappedFile::Close(size_t size)
+{
+	Unmap();
+
+	if (m_file >= 0 && m_writable && size != m_size && ftruncate(m_file, static_cast<off_t>(size)) != 0) {
+		close(m_file);
+		m_file = -1;
+		throw LastError("MappedFile: cannot truncate output file");
+	}
+
+	if (m_file >= 0)
+		close(m_file);
+	m_file = -1;
+	m_size = 0;
+}
+#endif
+
+void MappedFile::Close()
+{
+	Close(m_size);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other) {
+		try {
+			Close();
+		}
+		catch (...) {
+		}
+
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+		m_writable = std::exchange(other.m_writable, false);
+#ifdef _WIN32
+		m_file = std::exchange(other.m_file, nullptr);
+		m_mapping = std::exchange(other.m_mapping, nullptr);
+#else
+		m_file = std::exchange(other.m_file, -1);
+#endif
+	}
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	try {
+		Close();
+	}
+	catch (...) {
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+// A whole file mapped into memory: read-only for input, read-write for a newly created output.
+// Failures throw std::system_error.
+class MappedFile
+{
+	char* m_data = nullptr;
+	size_t m_size = 0;
+	bool m_writable = false;
+#ifdef _WIN32
+	void* m_file = nullptr;		// HANDLE
+	void* m_mapping = nullptr;	// HANDLE
+#else
+	int m_file = -1;
+#endif
+
+	MappedFile() = default;
+	void Unmap();
+public:
+	static MappedFile OpenRead(std::filesystem::path const& path);
+	// Creates path, or truncates an existing file, with room for size bytes
+	static MappedFile Create(std::filesystem::path const& path, size_t size);
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+	~MappedFile();
+
+	std::string_view View() const { return { m_data, m_size }; }
+	std::span<char> Span() { return { m_data, m_size }; }
+	size_t Size() const { return m_size; }
+
+	// Unmaps and closes the file; a writable one is first cut to its first size bytes
+	void Close(size_t size);
+	void Close();
+};
@@ -1,10 +1,10 @@
-#include "Form.hpp"
-
-#include <RmlUi/Core.h>
-#include <exception>
-
-void Form::Show()
-{
-	if (!m_doc) throw std::exception("Document was not initialized");
-	m_doc->Show();
+#include "Form.hpp"
+
+#include <RmlUi/Core.h>
+#include <exception>
+
+void Form::Show()
+{
+	if (!m_doc) throw std::exception("Document was not initialized");
+	m_doc->Show();
 }
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <memory_resource>
+
+// Passes allocations on to an upstream resource and counts them, e.g. to measure
+// how many allocations one call makes
+class CountingResource : public std::pmr::memory_resource
+{
+    std::pmr::memory_resource* m_upstream;
+    std::atomic<size_t> m_allocations{ 0 };
+    std::atomic<size_t> m_bytes{ 0 };
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* p = m_upstream->allocate(bytes, alignment);
+        m_allocations++;
+        m_bytes += bytes;
+        return p;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        m_upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : m_upstream(upstream) {}
+
+    size_t GetAllocations() const { return m_allocations; }
+    size_t GetBytes() const { return m_bytes; }
+
+    void Reset() {
+        m_allocations = 0;
+        m_bytes = 0;
+    }
+};
@@ -0,0 +1,53 @@
+#include "CpuFeatures.hpp"
+
+#if CPU_FEATURES_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace cpu_features {
+    namespace {
+        struct features {
+            bool sse41 = false;
+            bool sse42 = false;
+            bool avx2 = false;
+        };
+
+        features detect() {
+            features f;
+#if CPU_FEATURES_X86 && defined(_MSC_VER)
+            int regs[4];
+            __cpuid(regs, 0);
+            int max_leaf = regs[0];
+
+            __cpuid(regs, 1);
+            f.sse41 = (regs[2] & (1 << 19)) != 0;
+            f.sse42 = (regs[2] & (1 << 20)) != 0;
+            bool osxsave = (regs[2] & (1 << 27)) != 0;
+            bool avx = (regs[2] & (1 << 28)) != 0;
+
+            // AVX state has to be enabled by the OS, not only supported by the CPU
+            bool ymm_enabled = osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+            if (max_leaf >= 7 && ymm_enabled) {
+                __cpuidex(regs, 7, 0);
+                f.avx2 = (regs[1] & (1 << 5)) != 0;
+            }
+#elif CPU_FEATURES_X86
+            __builtin_cpu_init();
+            f.sse41 = __builtin_cpu_supports("sse4.1");
+            f.sse42 = __builtin_cpu_supports("sse4.2");
+            f.avx2 = __builtin_cpu_supports("avx2");
+#endif
+            return f;
+        }
+
+        features const& get() {
+            static const features f = detect();
+            return f;
+        }
+    }
+
+    bool has_sse41() { return get().sse41; }
+    bool has_sse42() { return get().sse42; }
+    bool has_avx2() { return get().avx2; }
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_FEATURES_X86 1
+#else
+#define CPU_FEATURES_X86 0
+#endif
+
+// Lets a single function use instructions above the translation unit's baseline.
+// MSVC accepts intrinsics for any instruction set without it.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CPU_TARGET(features)
+#else
+#define CPU_TARGET(features) __attribute__((target(features)))
+#endif
+
+namespace cpu_features {
+    bool has_sse41();
+    bool has_sse42();
+    bool has_avx2();
+};
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "Crc32c.hpp"
+#include "CpuFeatures.hpp"
+
+#include <array>
+#include <cstring>
+
+#if CPU_FEATURES_X86
+#include <immintrin.h>
+#endif
+
+namespace crc32c {
+    namespace {
+        constexpr uint32_t polynomial = 0x82F63B78; // reflected 0x1EDC6F41
+
+        // Slicing-by-8: tables[k][b] is the CRC of byte b followed by k zero bytes
+        using tables_t = std::array<std::array<uint32_t, 256>, 8>;
+
+        constexpr tables_t make_tables() {
+            tables_t tables{};
+            for (uint32_t b = 0; b < 256; ++b) {
+                uint32_t crc = b;
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = (crc >> 1) ^ (polynomial & (0u - (crc & 1)));
+                tables[0][b] = crc;
+            }
+            for (size_t k = 1; k < 8; ++k)
+                for (uint32_t b = 0; b < 256; ++b)
+                    tables[k][b] = (tables[k - 1][b] >> 8) ^ tables[0][tables[k - 1][b] & 0xFF];
+            return tables;
+        }
+
+        constexpr tables_t tables = make_tables();
+
+        uint32_t update_table(uint32_t crc, const unsigned char* p, size_t size) {
+            for (; size >= 8; p += 8, size -= 8) {
+                uint32_t low, high;
+                std::memcpy(&low, p, 4);
+                std::memcpy(&high, p + 4, 4);
+                low ^= crc;   // little-endian load, as on every platform this builds for
+                crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^
+                    tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+                    tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^
+                    tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+            }
+            for (; size; ++p, --size)
+                crc = (crc >> 8) ^ tables[0][(crc ^ *p) & 0xFF];
+            return crc;
+        }
+
+#if CPU_FEATURES_X86
+        CPU_TARGET("sse4.2")
+        uint32_t update_sse42(uint32_t crc, const unsigned char* p, size_t size) {
+#if defined(_M_X64) || defined(__x86_64__)
+            uint64_t wide = crc;
+            for (; size >= 8; p += 8, size -= 8) {
+                uint64_t word;
+                std::memcpy(&word, p, 8);
+                wide = _mm_crc32_u64(wide, word);
+            }
+            crc = static_cast<uint32_t>(wide);
+#endif
+            for (; size >= 4; p += 4, size -= 4) {
+                uint32_t word;
+                std::memcpy(&word, p, 4);
+                crc = _mm_crc32_u32(crc, word);
+            }
+            for (; size; ++p, --size)
+                crc = _mm_crc32_u8(crc, *p);
+            return crc;
+        }
+#endif
+    }
+
+    uint32_t update(uint32_t crc, const void* data, size_t size) {
+        auto p = static_cast<const unsigned char*>(data);
+#if CPU_FEATURES_X86
+        static const bool hardware = cpu_features::has_sse42();
+        if (hardware)
+            return ~update_sse42(~crc, p, size);
+#endif
+        return ~update_table(~crc, p, size);
+    }
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// CRC-32C (Castagnoli), the checksum of iSCSI and SSE4.2's crc32 instruction
+namespace crc32c {
+    // Continues crc over size more bytes; start from 0. Uses SSE4.2 when the CPU has it.
+    uint32_t update(uint32_t crc, const void* data, size_t size);
+
+    inline uint32_t compute(std::string_view data) {
+        return update(0, data.data(), data.size());
+    }
+};
@@ -0,0 +1,147 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+    // Thread count used when a caller passes 0
+    inline size_t default_threads() {
+        return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    // Worker threads that live as long as the pool and run submitted tasks in order.
+    // Workers are only ever added, on the first request for that many, up to a fixed limit;
+    // tasks beyond that wait in the queue for a free worker.
+    class thread_pool {
+        size_t m_limit;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::deque<std::function<void()>> m_tasks;
+        std::vector<std::thread> m_workers;
+        bool m_stop = false;
+
+        void run() {
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_wake.wait(lock, [&] { return m_stop || !m_tasks.empty(); });
+                    if (m_tasks.empty())
+                        return;
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+    public:
+        explicit thread_pool(size_t limit) : m_limit(std::max<size_t>(limit, 1)) {}
+        thread_pool(thread_pool const&) = delete;
+        thread_pool& operator=(thread_pool const&) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stop = true;
+            }
+            m_wake.notify_all();
+            for (auto& worker : m_workers)
+                worker.join();
+        }
+
+        size_t limit() const { return m_limit; }
+
+        // Starts workers until there are at least `workers`, or the limit
+        void reserve(size_t workers) {
+            std::lock_guard lock(m_mutex);
+            while (m_workers.size() < std::min(workers, m_limit))
+                m_workers.emplace_back([this] { run(); });
+        }
+
+        // Tasks must not throw
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard lock(m_mutex);
+                m_tasks.push_back(std::move(task));
+            }
+            m_wake.notify_one();
+        }
+    };
+
+    // The pool behind for_each, shared by every caller in the process. A few times the core count
+    // leaves room for nested calls, while an oversized thread count cannot start that many threads.
+    inline thread_pool& shared_pool() {
+        static thread_pool pool(4 * default_threads());
+        return pool;
+    }
+
+    // Calls f(i) for every i in [0, count) on up to `threads` threads (0 = default_threads()):
+    // the calling thread and workers of shared_pool(), so repeated calls start no threads.
+    // Asking for more threads than the pool allows runs on all of its workers instead.
+    // The first exception thrown by f is rethrown once every started call of f has returned.
+    // f may call for_each itself: the calling thread takes on whatever no worker got to.
+    template <class F>
+    void for_each(size_t count, size_t threads, F&& f) {
+        if (threads == 0) threads = default_threads();
+        threads = std::min(threads, count);
+        if (threads <= 1) {
+            for (size_t i = 0; i < count; ++i)
+                f(i);
+            return;
+        }
+
+        // Helpers may start after the call has returned, so what they touch is shared with them
+        struct state {
+            std::atomic<size_t> next{ 0 };
+            std::atomic<bool> failed{ false };
+            size_t done = 0;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        auto shared = std::make_shared<state>();
+
+        // Claimed indices are always counted as done by whoever claimed them; after a failure
+        // the rest are claimed without calling f
+        auto work = [shared, count, &f] {
+            size_t completed = 0;
+            for (size_t i = shared->next++; i < count; i = shared->next++) {
+                try {
+                    if (!shared->failed)
+                        f(i);
+                }
+                catch (...) {
+                    std::lock_guard lock(shared->mutex);
+                    if (!shared->error) shared->error = std::current_exception();
+                    shared->failed = true;
+                }
+                completed++;
+            }
+            if (completed) {
+                std::lock_guard lock(shared->mutex);
+                shared->done += completed;
+                if (shared->done == count)
+                    shared->finished.notify_all();
+            }
+        };
+
+        auto& pool = shared_pool();
+        size_t helpers = std::min(threads - 1, pool.limit());
+        pool.reserve(helpers);
+        for (size_t t = 0; t < helpers; ++t)
+            pool.submit(work);
+        work();
+
+        std::unique_lock lock(shared->mutex);
+        shared->finished.wait(lock, [&] { return shared->done == count; });
+        if (shared->error)
+            std::rethrow_exception(shared->error);
+    }
+};
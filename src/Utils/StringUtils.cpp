@@ -1,33 +1,403 @@
-#include "StringUtils.hpp"
-
-#include <algorithm>
-#include <utfcpp/utf8.h>
-
-namespace string_utils{
-    std::u32string utf8_to_u32(const std::string& input) {
-        std::u32string result;
-        utf8::utf8to32(input.begin(), input.end(), std::back_inserter(result));
-        return result;
-    }
-
-    std::string u32_to_utf8(const std::u32string& input) {
-        std::string result;
-        utf8::utf32to8(input.begin(), input.end(), std::back_inserter(result));
-        return result;
-    }
-
-    std::string to_upper(std::string const& str) {
-        auto res = utf8_to_u32(str);
-        std::transform(res.begin(), res.end(), res.begin(), 
-            static_cast<char32_t(*)(char32_t)>(to_upper));
-        return u32_to_utf8(res);
-
-    }
-
-    std::string to_lower(std::string const& str) {
-        auto res = utf8_to_u32(str);
-        std::transform(res.begin(), res.end(), res.begin(),
-            static_cast<char32_t(*)(char32_t)>(to_lower));
-        return u32_to_utf8(res);
-    }
+#include "StringUtils.hpp"
+#include "CpuFeatures.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <utfcpp/utf8.h>
+
+#if CPU_FEATURES_X86
+#include <immintrin.h>
+#endif
+
+namespace string_utils{
+    namespace {
+        using byte = unsigned char;
+
+        bool is_valid_code_point(char32_t c) {
+            return c <= 0x10FFFF && (c & 0xFFFFF800) != 0xD800;
+        }
+
+        // 1- and 2-byte sequences are decoded inline; longer and malformed ones go through utfcpp,
+        // which also raises the same exceptions utf8to32 would
+        inline char32_t decode_one(const char*& p, const char* end) {
+            byte lead = static_cast<byte>(*p);
+            if (lead < 0x80) {
+                ++p;
+                return lead;
+            }
+            if (lead >= 0xC2 && lead <= 0xDF && end - p >= 2) {
+                byte cont = static_cast<byte>(p[1]);
+                if ((cont & 0xC0) == 0x80) {
+                    p += 2;
+                    return ((lead & 0x1F) << 6) | (cont & 0x3F);
+                }
+            }
+            return utf8::next(p, end);
+        }
+
+        // Exact for valid input; malformed input throws while decoding, before the count matters
+        size_t count_code_points_scalar(const char* p, const char* end) {
+            size_t count = 0;
+            for (; p != end; ++p)
+                count += (static_cast<byte>(*p) & 0xC0) != 0x80;
+            return count;
+        }
+
+        size_t count_utf8_bytes_scalar(const char32_t* p, const char32_t* end) {
+            size_t count = 0;
+            for (; p != end; ++p) {
+                if (!is_valid_code_point(*p))
+                    throw utf8::invalid_code_point(*p);
+                count += utf8_length(*p);
+            }
+            return count;
+        }
+
+        void decode_scalar(const char* p, const char* end, char32_t* out, char32_t*) {
+            while (p != end)
+                *out++ = decode_one(p, end);
+        }
+
+        void encode_scalar(const char32_t* p, const char32_t* end, char* out, char*) {
+            for (; p != end; ++p)
+                out = write_utf8(out, *p);
+        }
+
+        // Mixed text leaves vector steps with only a few code points each; a short scalar
+        // run over the next block is cheaper than retrying the vector step after every one
+        constexpr size_t scalar_run = 16;
+
+        inline const char* decode_scalar_run(const char* p, const char* end, char32_t*& out) {
+            const char* stop = p + std::min<size_t>(scalar_run, end - p);
+            while (p < stop)
+                *out++ = decode_one(p, end);
+            return p;
+        }
+
+        inline const char32_t* encode_scalar_run(const char32_t* p, const char32_t* end, char*& out) {
+            const char32_t* stop = p + std::min<size_t>(scalar_run, end - p);
+            for (; p != stop; ++p)
+                out = write_utf8(out, *p);
+            return p;
+        }
+
+#if CPU_FEATURES_X86
+        CPU_TARGET("sse4.1")
+        size_t count_code_points_sse41(const char* p, const char* end) {
+            size_t continuation = 0;
+            const char* start = p;
+            while (end - p >= 16) {
+                // Per-byte counters are flushed before they can overflow
+                __m128i acc = _mm_setzero_si128();
+                for (int i = 0; i < 255 && end - p >= 16; ++i, p += 16) {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                    // 0x80..0xBF are the only bytes below -64 as signed chars
+                    acc = _mm_sub_epi8(acc, _mm_cmplt_epi8(v, _mm_set1_epi8(-64)));
+                }
+                __m128i sums = _mm_sad_epu8(acc, _mm_setzero_si128());
+                continuation += _mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4);
+            }
+            return (p - start) - continuation + count_code_points_scalar(p, end);
+        }
+
+        CPU_TARGET("sse4.1")
+        void decode_sse41(const char* p, const char* end, char32_t* out, char32_t* out_end) {
+            const __m128i lead_pattern = _mm_set1_epi16(static_cast<short>(0x80C0));
+            const __m128i lead_bits = _mm_set1_epi16(static_cast<short>(0xC0E0));
+
+            while (end - p >= 16 && out_end - out >= 16) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+                // Leading ASCII bytes
+                unsigned high = static_cast<unsigned>(_mm_movemask_epi8(v));
+                if ((high & 1) == 0) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_cvtepu8_epi32(v));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_cvtepu8_epi32(_mm_srli_si128(v, 4)));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_cvtepu8_epi32(_mm_srli_si128(v, 12)));
+                    size_t ascii = high ? std::countr_zero(high) : 16;
+                    p += ascii;
+                    out += ascii;
+                    if (ascii < 8)
+                        p = decode_scalar_run(p, end, out);
+                    continue;
+                }
+
+                // Leading 2-byte sequences (U+0080..U+07FF): 110xxxxx 10xxxxxx, lead not overlong
+                __m128i pairs = _mm_cmpeq_epi16(_mm_and_si128(v, lead_bits), lead_pattern);
+                __m128i overlong = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(0x1E)), _mm_setzero_si128());
+                unsigned valid = static_cast<unsigned>(_mm_movemask_epi8(_mm_andnot_si128(overlong, pairs)));
+                size_t count = std::countr_one(valid) / 2;
+                if (count) {
+                    __m128i hi = _mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x1F)), 6);
+                    __m128i lo = _mm_and_si128(_mm_srli_epi16(v, 8), _mm_set1_epi16(0x3F));
+                    __m128i cp = _mm_or_si128(hi, lo);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_cvtepu16_epi32(cp));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_cvtepu16_epi32(_mm_srli_si128(cp, 8)));
+                    p += count * 2;
+                    out += count;
+                    if (count < 4)
+                        p = decode_scalar_run(p, end, out);
+                    continue;
+                }
+
+                *out++ = decode_one(p, end);
+            }
+
+            decode_scalar(p, end, out, out_end);
+        }
+
+        CPU_TARGET("sse4.1")
+        size_t count_utf8_bytes_sse41(const char32_t* p, const char32_t* end) {
+            const __m128i max = _mm_set1_epi32(0x10FFFF);
+            size_t count = 0;
+            while (end - p >= 4) {
+                // Lanes gain at most 3 per step, the batch bound keeps them from overflowing
+                __m128i acc = _mm_setzero_si128();
+                const char32_t* batch_end = p + std::min<size_t>((end - p) & ~size_t(3), size_t(1) << 24);
+                for (; p != batch_end; p += 4) {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                    __m128i in_range = _mm_cmpeq_epi32(_mm_max_epu32(v, max), max);
+                    __m128i surrogate = _mm_cmpeq_epi32(_mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFFFFF800))),
+                        _mm_set1_epi32(0xD800));
+                    if (_mm_movemask_epi8(_mm_andnot_si128(surrogate, in_range)) != 0xFFFF)
+                        return count_utf8_bytes_scalar(p, end);
+
+                    acc = _mm_sub_epi32(acc, _mm_cmpgt_epi32(v, _mm_set1_epi32(0x7F)));
+                    acc = _mm_sub_epi32(acc, _mm_cmpgt_epi32(v, _mm_set1_epi32(0x7FF)));
+                    acc = _mm_sub_epi32(acc, _mm_cmpgt_epi32(v, _mm_set1_epi32(0xFFFF)));
+                    count += 4;
+                }
+                acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+                acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 4));
+                count += static_cast<uint32_t>(_mm_cvtsi128_si32(acc));
+            }
+            return count + count_utf8_bytes_scalar(p, end);
+        }
+
+        CPU_TARGET("sse4.1")
+        void encode_sse41(const char32_t* p, const char32_t* end, char* out, char* out_end) {
+            while (end - p >= 8 && out_end - out >= 16) {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4));
+                // Code points were validated, so saturation only hits lanes no fast path accepts
+                __m128i w = _mm_packus_epi32(a, b);
+
+                unsigned wide = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi16(w, _mm_set1_epi16(0x7F)))) |
+                    static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi16(w, _mm_setzero_si128())));
+                if ((wide & 1) == 0) {
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(w, w));
+                    size_t ascii = wide ? std::countr_zero(wide) / 2 : 8;
+                    p += ascii;
+                    out += ascii;
+                    if (ascii < 4)
+                        p = encode_scalar_run(p, end, out);
+                    continue;
+                }
+
+                __m128i two = _mm_and_si128(_mm_cmpgt_epi16(w, _mm_set1_epi16(0x7F)),
+                    _mm_cmplt_epi16(w, _mm_set1_epi16(0x800)));
+                size_t count = std::countr_one(static_cast<unsigned>(_mm_movemask_epi8(two))) / 2;
+                if (count) {
+                    __m128i lead = _mm_or_si128(_mm_srli_epi16(w, 6), _mm_set1_epi16(0xC0));
+                    __m128i cont = _mm_or_si128(_mm_and_si128(w, _mm_set1_epi16(0x3F)), _mm_set1_epi16(0x80));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_or_si128(lead, _mm_slli_epi16(cont, 8)));
+                    p += count;
+                    out += count * 2;
+                    if (count < 4)
+                        p = encode_scalar_run(p, end, out);
+                    continue;
+                }
+
+                out = write_utf8(out, *p++);
+            }
+
+            encode_scalar(p, end, out, out_end);
+        }
+
+        CPU_TARGET("avx2")
+        size_t count_code_points_avx2(const char* p, const char* end) {
+            size_t continuation = 0;
+            const char* start = p;
+            while (end - p >= 32) {
+                __m256i acc = _mm256_setzero_si256();
+                for (int i = 0; i < 255 && end - p >= 32; ++i, p += 32) {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                    acc = _mm256_sub_epi8(acc, _mm256_cmpgt_epi8(_mm256_set1_epi8(-64), v));
+                }
+                __m256i sums = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+                continuation += static_cast<size_t>(_mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1) +
+                    _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3));
+            }
+            return (p - start) - continuation + count_code_points_scalar(p, end);
+        }
+
+        CPU_TARGET("avx2")
+        size_t count_utf8_bytes_avx2(const char32_t* p, const char32_t* end) {
+            const __m256i max = _mm256_set1_epi32(0x10FFFF);
+            size_t count = 0;
+            while (end - p >= 8) {
+                __m256i acc = _mm256_setzero_si256();
+                const char32_t* batch_end = p + std::min<size_t>((end - p) & ~size_t(7), size_t(1) << 24);
+                for (; p != batch_end; p += 8) {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                    __m256i in_range = _mm256_cmpeq_epi32(_mm256_max_epu32(v, max), max);
+                    __m256i surrogate = _mm256_cmpeq_epi32(_mm256_and_si256(v, _mm256_set1_epi32(static_cast<int>(0xFFFFF800))),
+                        _mm256_set1_epi32(0xD800));
+                    if (static_cast<unsigned>(_mm256_movemask_epi8(_mm256_andnot_si256(surrogate, in_range))) != 0xFFFFFFFFu)
+                        return count_utf8_bytes_scalar(p, end);
+
+                    acc = _mm256_sub_epi32(acc, _mm256_cmpgt_epi32(v, _mm256_set1_epi32(0x7F)));
+                    acc = _mm256_sub_epi32(acc, _mm256_cmpgt_epi32(v, _mm256_set1_epi32(0x7FF)));
+                    acc = _mm256_sub_epi32(acc, _mm256_cmpgt_epi32(v, _mm256_set1_epi32(0xFFFF)));
+                    count += 8;
+                }
+                __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+                sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+                sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+                count += static_cast<uint32_t>(_mm_cvtsi128_si32(sum));
+            }
+            return count + count_utf8_bytes_scalar(p, end);
+        }
+
+        CPU_TARGET("avx2")
+        void encode_avx2(const char32_t* p, const char32_t* end, char* out, char* out_end) {
+            while (end - p >= 16 && out_end - out >= 32) {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 8));
+                // packus works per 128-bit lane, restore code point order afterwards
+                __m256i w = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+
+                unsigned wide = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi16(w, _mm256_set1_epi16(0x7F)))) |
+                    static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi16(_mm256_setzero_si256(), w)));
+                if ((wide & 1) == 0) {
+                    __m256i bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(w, w), 0xD8);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(bytes));
+                    size_t ascii = wide ? std::countr_zero(wide) / 2 : 16;
+                    p += ascii;
+                    out += ascii;
+                    if (ascii < 8)
+                        p = encode_scalar_run(p, end, out);
+                    continue;
+                }
+
+                __m256i two = _mm256_and_si256(_mm256_cmpgt_epi16(w, _mm256_set1_epi16(0x7F)),
+                    _mm256_cmpgt_epi16(_mm256_set1_epi16(0x800), w));
+                size_t count = std::countr_one(static_cast<unsigned>(_mm256_movemask_epi8(two))) / 2;
+                if (count) {
+                    __m256i lead = _mm256_or_si256(_mm256_srli_epi16(w, 6), _mm256_set1_epi16(0xC0));
+                    __m256i cont = _mm256_or_si256(_mm256_and_si256(w, _mm256_set1_epi16(0x3F)), _mm256_set1_epi16(0x80));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_or_si256(lead, _mm256_slli_epi16(cont, 8)));
+                    p += count;
+                    out += count * 2;
+                    if (count < 8)
+                        p = encode_scalar_run(p, end, out);
+                    continue;
+                }
+
+                out = write_utf8(out, *p++);
+            }
+
+            encode_sse41(p, end, out, out_end);
+        }
+#endif
+
+        struct transcoder {
+            size_t (*count_code_points)(const char*, const char*);
+            void (*decode)(const char*, const char*, char32_t*, char32_t*);
+            size_t (*count_utf8_bytes)(const char32_t*, const char32_t*);
+            void (*encode)(const char32_t*, const char32_t*, char*, char*);
+        };
+
+        transcoder const& transcoder_for(simd_level level) {
+            static const transcoder scalar{ count_code_points_scalar, decode_scalar, count_utf8_bytes_scalar, encode_scalar };
+#if CPU_FEATURES_X86
+            static const transcoder sse41{ count_code_points_sse41, decode_sse41, count_utf8_bytes_sse41, encode_sse41 };
+            // Decoding stays on SSE4.1: UTF-8 runs of one sequence length are short in mixed text, and a
+            // 32-byte kernel measured slower than the 16-byte one on Cyrillic
+            static const transcoder avx2{ count_code_points_avx2, decode_sse41, count_utf8_bytes_avx2, encode_avx2 };
+            if (level == simd_level::avx2) return avx2;
+            if (level == simd_level::sse41) return sse41;
+#endif
+            return scalar;
+        }
+
+        simd_level best_simd_level() {
+            if (cpu_features::has_avx2()) return simd_level::avx2;
+            if (cpu_features::has_sse41()) return simd_level::sse41;
+            return simd_level::scalar;
+        }
+
+        std::atomic<simd_level>& active_level() {
+            static std::atomic<simd_level> level{ best_simd_level() };
+            return level;
+        }
+    }
+
+    simd_level get_simd_level() {
+        return active_level().load(std::memory_order_relaxed);
+    }
+
+    void set_simd_level(simd_level level) {
+        active_level().store(std::min(level, best_simd_level()), std::memory_order_relaxed);
+    }
+
+    std::u32string utf8_to_u32(const std::string& input) {
+        auto const& impl = transcoder_for(get_simd_level());
+        const char* begin = input.data();
+        const char* end = begin + input.size();
+
+        std::u32string result(impl.count_code_points(begin, end), U'\0');
+        impl.decode(begin, end, result.data(), result.data() + result.size());
+        return result;
+    }
+
+    std::pmr::u32string utf8_to_u32(std::string_view input, std::pmr::memory_resource* resource) {
+        auto const& impl = transcoder_for(get_simd_level());
+        const char* begin = input.data();
+        const char* end = begin + input.size();
+
+        std::pmr::u32string result(impl.count_code_points(begin, end), U'\0', resource);
+        impl.decode(begin, end, result.data(), result.data() + result.size());
+        return result;
+    }
+
+    std::string u32_to_utf8(const std::u32string& input) {
+        auto const& impl = transcoder_for(get_simd_level());
+        const char32_t* begin = input.data();
+        const char32_t* end = begin + input.size();
+
+        std::string result(impl.count_utf8_bytes(begin, end), '\0');
+        impl.encode(begin, end, result.data(), result.data() + result.size());
+        return result;
+    }
+
+    char32_t next_code_point_slow(const char*& it, const char* end) {
+        return decode_one(it, end);
+    }
+
+    size_t incomplete_utf8_suffix(const char* begin, const char* end) {
+        for (size_t back = 1; back <= 3 && back <= static_cast<size_t>(end - begin); ++back) {
+            unsigned char c = static_cast<unsigned char>(end[-static_cast<ptrdiff_t>(back)]);
+            if ((c & 0xC0) != 0x80)
+                return utf8_sequence_length(c) > back ? back : 0;
+        }
+        return 0;
+    }
+
+    std::string to_upper(std::string const& str) {
+        auto res = utf8_to_u32(str);
+        std::transform(res.begin(), res.end(), res.begin(),
+            static_cast<char32_t(*)(char32_t)>(to_upper));
+        return u32_to_utf8(res);
+
+    }
+
+    std::string to_lower(std::string const& str) {
+        auto res = utf8_to_u32(str);
+        std::transform(res.begin(), res.end(), res.begin(),
+            static_cast<char32_t(*)(char32_t)>(to_lower));
+        return u32_to_utf8(res);
+    }
 }
\ No newline at end of file
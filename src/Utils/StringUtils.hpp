@@ -1,30 +1,118 @@
-#pragma once
-#include <string>
-
-namespace string_utils {
-    inline char32_t to_upper(char32_t c) {
-        if (c >= U'a' && c <= U'z') return c - 32;
-        if (c >= U'а' && c <= U'я') return c - 32;
-        if (c == U'ё') return U'Ё';
-        return c;
-    }
-
-    inline char32_t to_lower(char32_t c) {
-        if (c >= U'A' && c <= U'Z') return c + 32;
-        if (c >= U'А' && c <= U'Я') return c + 32;
-        if (c == U'Ё') return U'ё';
-        return c;
-    }
-
-    inline uint64_t str_hash(std::u32string const& str) {
-        uint64_t hash = 5381;
-        for (char32_t c : str)
-            hash = ((hash << 5) + hash) + c;
-        return hash;
-    }
-
-    std::string to_upper(std::string const& str);
-    std::string to_lower(std::string const& str);
-    std::u32string utf8_to_u32(const std::string& input);
-    std::string u32_to_utf8(const std::u32string& input);
+#pragma once
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+namespace string_utils {
+    inline char32_t to_upper(char32_t c) {
+        if (c >= U'a' && c <= U'z') return c - 32;
+        if (c >= U'а' && c <= U'я') return c - 32;
+        if (c == U'ё') return U'Ё';
+        return c;
+    }
+
+    inline char32_t to_lower(char32_t c) {
+        if (c >= U'A' && c <= U'Z') return c + 32;
+        if (c >= U'А' && c <= U'Я') return c + 32;
+        if (c == U'Ё') return U'ё';
+        return c;
+    }
+
+    inline uint64_t str_hash(std::u32string_view str) {
+        uint64_t hash = 5381;
+        for (char32_t c : str)
+            hash = ((hash << 5) + hash) + c;
+        return hash;
+    }
+
+    char32_t next_code_point_slow(const char*& it, const char* end);
+
+    // Reads one code point and advances it past it; throws utf8::exception on malformed input
+    inline char32_t next_code_point(const char*& it, const char* end) {
+        unsigned char lead = static_cast<unsigned char>(*it);
+        if (lead < 0x80) {
+            ++it;
+            return lead;
+        }
+        return next_code_point_slow(it, end);
+    }
+
+    // Length of the UTF-8 sequence introduced by lead, 0 if lead cannot start one
+    inline size_t utf8_sequence_length(unsigned char lead) {
+        if (lead < 0x80) return 1;
+        if (lead < 0xC0) return 0;
+        if (lead < 0xE0) return 2;
+        if (lead < 0xF0) return 3;
+        if (lead < 0xF8) return 4;
+        return 0;
+    }
+
+    // Number of bytes at the end of [begin, end) that start a UTF-8 sequence without completing it
+    size_t incomplete_utf8_suffix(const char* begin, const char* end);
+
+    inline size_t utf8_length(char32_t c) {
+        return 1 + (c >= 0x80) + (c >= 0x800) + (c >= 0x10000);
+    }
+
+    // Writes the UTF-8 form of c to out and returns the end of it
+    inline char* write_utf8(char* out, char32_t c) {
+        if (c < 0x80) {
+            *out++ = static_cast<char>(c);
+        }
+        else if (c < 0x800) {
+            *out++ = static_cast<char>(0xC0 | (c >> 6));
+            *out++ = static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else if (c < 0x10000) {
+            *out++ = static_cast<char>(0xE0 | (c >> 12));
+            *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else {
+            *out++ = static_cast<char>(0xF0 | (c >> 18));
+            *out++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (c & 0x3F));
+        }
+        return out;
+    }
+
+    inline void append_utf8(std::string& out, char32_t c) {
+        if (c < 0x80) {
+            out.push_back(static_cast<char>(c));
+        }
+        else if (c < 0x800) {
+            char bytes[] = { static_cast<char>(0xC0 | (c >> 6)), static_cast<char>(0x80 | (c & 0x3F)) };
+            out.append(bytes, 2);
+        }
+        else if (c < 0x10000) {
+            char bytes[] = { static_cast<char>(0xE0 | (c >> 12)), static_cast<char>(0x80 | ((c >> 6) & 0x3F)),
+                static_cast<char>(0x80 | (c & 0x3F)) };
+            out.append(bytes, 3);
+        }
+        else {
+            char bytes[] = { static_cast<char>(0xF0 | (c >> 18)), static_cast<char>(0x80 | ((c >> 12) & 0x3F)),
+                static_cast<char>(0x80 | ((c >> 6) & 0x3F)), static_cast<char>(0x80 | (c & 0x3F)) };
+            out.append(bytes, 4);
+        }
+    }
+
+    // Vector instruction set used by utf8_to_u32 / u32_to_utf8, detected at startup. At avx2 the
+    // UTF-8 decode itself still runs the sse41 kernel, which is faster on mixed text.
+    enum class simd_level {
+        scalar,
+        sse41,
+        avx2
+    };
+
+    simd_level get_simd_level();
+    // Never selects more than the CPU supports
+    void set_simd_level(simd_level level);
+
+    std::string to_upper(std::string const& str);
+    std::string to_lower(std::string const& str);
+    std::u32string utf8_to_u32(const std::string& input);
+    std::pmr::u32string utf8_to_u32(std::string_view input, std::pmr::memory_resource* resource);
+    std::string u32_to_utf8(const std::u32string& input);
 };
\ No newline at end of file